@@ -20,4 +20,5 @@ find_package_handle_standard_args(Common613 DEFAULT_MSG
 add_library(Common613 INTERFACE IMPORTED ${Common613_HEADERS})
 target_include_directories(Common613 INTERFACE ${Common613_INCLUDE_DIRS})
 target_link_libraries(Common613 INTERFACE ${Common613_LIBRARIES})
+target_compile_definitions(Common613 INTERFACE ${Common613_DEFINITIONS})
 add_library(Common613::Common613 ALIAS Common613)
@@ -1,12 +1,22 @@
 find_package(fmt REQUIRED)
 set(COMMON613_fmt_LIBRARIES fmt::fmt)
 
-if (WIN32)
-    set(Boost_USE_STATIC_LIBS OFF)
-    add_definitions(-DBOOST_ALL_NO_LIB -DBOOST_LOG_DYN_LINK)
-endif ()
-find_package(Boost REQUIRED COMPONENTS log log_setup)
-set(COMMON613_BOOST_LIBRARIES Boost::log Boost::log_setup Boost::boost)
+find_package(Threads REQUIRED)
+set(COMMON613_Threads_LIBRARIES Threads::Threads)
+set(COMMON613_DL_LIBRARIES ${CMAKE_DL_LIBS})
+
+option(COMMON613_LIGHT_ASSERT "Report failed assertions to stderr or a callback instead of Boost.Log" OFF)
+if (COMMON613_LIGHT_ASSERT)
+    set(Common613_DEFINITIONS COMMON613_LIGHT_ASSERT=1)
+    set(COMMON613_BOOST_LIBRARIES)
+else (COMMON613_LIGHT_ASSERT)
+    if (WIN32)
+        set(Boost_USE_STATIC_LIBS OFF)
+        add_definitions(-DBOOST_ALL_NO_LIB -DBOOST_LOG_DYN_LINK)
+    endif ()
+    find_package(Boost REQUIRED COMPONENTS log log_setup)
+    set(COMMON613_BOOST_LIBRARIES Boost::log Boost::log_setup Boost::boost)
+endif (COMMON613_LIGHT_ASSERT)
 if (MSVC)
     add_definitions(-D_CRT_SECURE_NO_WARNINGS -DNOMINMAX)
     set(CMAKE_C_FLAGS "${CMAKE_C_FLAGS} /utf-8")
@@ -14,6 +24,9 @@ if (MSVC)
 endif (MSVC)
 
 if (COMMON613_STACKTRACE_DEBUG)
+    if (COMMON613_STACKTRACE_RAW)
+        add_definitions(-DCOMMON613_STACKTRACE_RAW=1)
+    endif(COMMON613_STACKTRACE_RAW)
     find_package(Boost COMPONENTS stacktrace_windbg)
     if (Boost_stacktrace_windbg_FOUND)
         add_definitions(-DCOMMON613_STACKTRACE_DEBUG=1)
@@ -38,13 +51,32 @@ endif(COMMON613_STACKTRACE_DEBUG)
 set(Common613_HEADERS
         common613/compat/cpp17.h
         common613/compat/file_system.h
+        common613/compat/simd.h
+        common613/compat/string_view.h
         common613/assert.h
+        common613/atomic_writer.h
         common613/checked_cast.h
+        common613/direct_io.h
+        common613/directory_loader.h
+        common613/endian.h
+        common613/file_pipeline.h
+        common613/file_result.h
         common613/file_utils.h
+        common613/flat_hash_map.h
         common613/memory.h
+        common613/record_reader.h
+        common613/ring_queue.h
+        common613/stacktrace.h
         common613/struct_size_check.h
+        common613/thread_pool.h
+        common613/vector_affine.h
         common613/vector_arith_utils.h
+        common613/vector_box.h
+        common613/vector_codec.h
         common613/vector_definitions.h
+        common613/vector_format.h
+        common613/vector_hash.h
+        common613/vector_stencil.h
 )
 
 find_path(Common613_INCLUDE_DIR
@@ -58,4 +90,4 @@ find_path(Common613_INCLUDE_DIR
 )
 
 set(Common613_INCLUDE_DIRS ${Common613_INCLUDE_DIR})
-set(Common613_LIBRARIES ${COMMON613_fmt_LIBRARIES} ${COMMON613_BOOST_LIBRARIES})
+set(Common613_LIBRARIES ${COMMON613_fmt_LIBRARIES} ${COMMON613_Threads_LIBRARIES} ${COMMON613_DL_LIBRARIES} ${COMMON613_BOOST_LIBRARIES})
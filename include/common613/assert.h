@@ -10,10 +10,77 @@
 
 #include <cstdio>
 #include <fmt/format.h>
-#include <boost/log/trivial.hpp>
+
+/// @def COMMON613_LIGHT_ASSERT
+/// @brief If defined as @c 1, messages go to minimal sinks, see @ref common613::setFatalSink and
+/// @ref common613::setDebugSink, instead of Boost.Log, so that Boost is not needed.
+/// @def COMMON613_LOG_FATAL
+/// @brief Logs @p message at fatal level.
+/// @def COMMON613_LOG_DEBUG
+/// @brief Logs @p message at debug level.
+#if defined(COMMON613_LIGHT_ASSERT) && COMMON613_LIGHT_ASSERT == 1
+
+# include <atomic>
+# include <string>
+
+namespace common613 {
+
+/// @brief Receives messages logged at fatal level with @c COMMON613_LIGHT_ASSERT, e.g. of failed assertions.
+using FatalSink = void (*)(const std::string& message);
+
+/// @brief Receives messages logged at debug level with @c COMMON613_LIGHT_ASSERT, e.g. stack traces.
+/// @note Stack traces of @ref COMMON613_TRACE are delivered from a background thread.
+using DebugSink = void (*)(const std::string& message);
+
+/// @cond
+namespace internal {
+
+inline void writeToStderr(const std::string& message) {
+  std::fwrite(message.data(), 1, message.size(), stderr);
+  std::fputc('\n', stderr);
+}
+
+inline std::atomic<FatalSink>& fatalSink() {
+  static std::atomic<FatalSink> sink{&writeToStderr};
+  return sink;
+}
+
+inline std::atomic<DebugSink>& debugSink() {
+  static std::atomic<DebugSink> sink{&writeToStderr};
+  return sink;
+}
+
+}
+/// @endcond
+
+/// @brief Replaces the sink of fatal messages, which writes lines to @c stderr by default.
+/// @param sink The new sink, or @c nullptr to restore the default.
+/// @return The previous sink.
+inline FatalSink setFatalSink(FatalSink sink) {
+  return internal::fatalSink().exchange(sink != nullptr ? sink : &internal::writeToStderr);
+}
+
+/// @brief Replaces the sink of debug messages, which writes lines to @c stderr by default.
+/// @param sink The new sink, or @c nullptr to restore the default.
+/// @return The previous sink.
+inline DebugSink setDebugSink(DebugSink sink) {
+  return internal::debugSink().exchange(sink != nullptr ? sink : &internal::writeToStderr);
+}
+
+}
+
+# define COMMON613_LOG_FATAL(message) (::common613::internal::fatalSink().load()(message))
+# define COMMON613_LOG_DEBUG(message) (::common613::internal::debugSink().load()(message))
+#else
+
+# include <boost/log/trivial.hpp>
 
 namespace common613 {}
 
+# define COMMON613_LOG_FATAL(message) BOOST_LOG_TRIVIAL(fatal) << (message)
+# define COMMON613_LOG_DEBUG(message) BOOST_LOG_TRIVIAL(debug) << (message)
+#endif
+
 /// @cond
 #define COMMON613_STRINGIZE_DETAIL(x) #x
 /// @endcond
@@ -23,12 +90,16 @@ namespace common613 {}
 #define COMMON613_STRINGIZE(x) COMMON613_STRINGIZE_DETAIL(x)
 
 /// @def COMMON613_TRACE
-/// @brief Prints stack trace if @c COMMON613_STACKTRACE_DEBUG is defined.
+/// @brief Logs stack trace if @c COMMON613_STACKTRACE_DEBUG is defined.
+///
+/// Only raw addresses are captured at the call site. They are symbolized and logged on a background thread,
+/// see @ref common613::TraceSymbolizer.
 #if defined(COMMON613_STACKTRACE_DEBUG) && COMMON613_STACKTRACE_DEBUG == 1
 
-# include <boost/stacktrace.hpp>
+# include <common613/stacktrace.h>
 
-# define COMMON613_TRACE() do { BOOST_LOG_TRIVIAL(debug) << boost::stacktrace::stacktrace() << std::endl; } while(0)
+# define COMMON613_TRACE() \
+  do { ::common613::TraceSymbolizer::instance().post(::common613::RawStackTrace::capture()); } while(0)
 #else
 # define COMMON613_TRACE() ((void) 0)
 
@@ -44,7 +115,7 @@ namespace common613 {}
 #if __cplusplus >= 202002L
 # define COMMON613_FATAL(fmtStr, ...) \
   do {                                     \
-    BOOST_LOG_TRIVIAL(fatal) << fmt::format( __FILE__ ":" COMMON613_STRINGIZE( __LINE__ ) " " fmtStr __VA_OPT(,)__ __VA_ARGS__); \
+    COMMON613_LOG_FATAL(fmt::format( __FILE__ ":" COMMON613_STRINGIZE( __LINE__ ) " " fmtStr __VA_OPT(,)__ __VA_ARGS__)); \
     COMMON613_TRACE();               \
     throw std::runtime_error("");          \
   } while(0)
@@ -52,7 +123,7 @@ namespace common613 {}
 # define COMMON613_REQUIRE(cond, fmtStr, ...)         \
   do {                                     \
     if (!(cond)) {                         \
-      BOOST_LOG_TRIVIAL(fatal) << fmt::format(__FILE__ ":" COMMON613_STRINGIZE(__LINE__) " (" #cond ") " fmtStr __VA_OPT(,)__ __VA_ARGS__); \
+      COMMON613_LOG_FATAL(fmt::format(__FILE__ ":" COMMON613_STRINGIZE(__LINE__) " (" #cond ") " fmtStr __VA_OPT(,)__ __VA_ARGS__)); \
       COMMON613_TRACE();             \
       throw std::runtime_error("");        \
     }                                      \
@@ -67,7 +138,7 @@ namespace common613 {}
 #elif defined(_MSC_VER)
 # define COMMON613_FATAL(fmtStr, ...) \
   do {                                     \
-    BOOST_LOG_TRIVIAL(fatal) << fmt::format( __FILE__ ":" COMMON613_STRINGIZE( __LINE__ ) " " fmtStr, __VA_ARGS__); \
+    COMMON613_LOG_FATAL(fmt::format( __FILE__ ":" COMMON613_STRINGIZE( __LINE__ ) " " fmtStr, __VA_ARGS__)); \
     COMMON613_TRACE();               \
     throw std::runtime_error("");          \
   } while(0)
@@ -75,7 +146,7 @@ namespace common613 {}
 # define COMMON613_REQUIRE(cond, fmtStr, ...)         \
   do {                                     \
     if (!(cond)) {                         \
-      BOOST_LOG_TRIVIAL(fatal) << fmt::format(__FILE__ ":" COMMON613_STRINGIZE(__LINE__) " (" #cond ") " fmtStr, __VA_ARGS__); \
+      COMMON613_LOG_FATAL(fmt::format(__FILE__ ":" COMMON613_STRINGIZE(__LINE__) " (" #cond ") " fmtStr, __VA_ARGS__)); \
       COMMON613_TRACE();             \
       throw std::runtime_error("");        \
     }                                      \
@@ -90,7 +161,7 @@ namespace common613 {}
 #elif defined(__GNUC__)
 # define COMMON613_FATAL(fmtStr, ...) \
   do {                                     \
-    BOOST_LOG_TRIVIAL(fatal) << fmt::format( __FILE__ ":" COMMON613_STRINGIZE( __LINE__ ) " " fmtStr, ##__VA_ARGS__); \
+    COMMON613_LOG_FATAL(fmt::format( __FILE__ ":" COMMON613_STRINGIZE( __LINE__ ) " " fmtStr, ##__VA_ARGS__)); \
     COMMON613_TRACE();               \
     throw std::runtime_error("");          \
   } while(0)
@@ -98,7 +169,7 @@ namespace common613 {}
 # define COMMON613_REQUIRE(cond, fmtStr, ...)         \
   do {                                     \
     if (!(cond)) {                         \
-      BOOST_LOG_TRIVIAL(fatal) << fmt::format(__FILE__ ":" COMMON613_STRINGIZE(__LINE__) " (" #cond ") " fmtStr, ##__VA_ARGS__); \
+      COMMON613_LOG_FATAL(fmt::format(__FILE__ ":" COMMON613_STRINGIZE(__LINE__) " (" #cond ") " fmtStr, ##__VA_ARGS__)); \
       COMMON613_TRACE();             \
       throw std::runtime_error("");        \
     }                                      \
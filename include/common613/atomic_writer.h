@@ -0,0 +1,229 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+/// @file
+/// @brief Writes files atomically through a temporary file, with control over preallocation and durability.
+
+#pragma once
+#ifndef COMMON613_ATOMIC_WRITER_H
+#define COMMON613_ATOMIC_WRITER_H
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <string>
+#include <common613/assert.h>
+#include <common613/file_utils.h>
+#include <common613/compat/cpp17.h>
+#include <common613/compat/file_system.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+# include <fcntl.h>
+# include <sys/stat.h>
+# include <unistd.h>
+# define COMMON613_ATOMIC_WRITER_POSIX 1
+#endif
+
+namespace common613 {
+
+namespace file {
+
+/// @brief Options for @ref AtomicWriter.
+struct AtomicWriteOptions {
+  /// @brief Bytes to reserve on disk up front, to avoid fragmentation. 0 to disable.
+  std::size_t preallocate = 0;
+  /// @brief Starts background writeback every @c syncInterval bytes, so that the final sync is short.
+  /// 0 to disable. Only effective on Linux.
+  std::size_t syncInterval = 0;
+  /// @brief Whether to sync data and the directory entry on @ref AtomicWriter::commit.
+  bool durable = true;
+};
+
+/**
+ * @brief Writes a file via a temporary file in the same directory, which replaces the target on @ref commit.
+ *
+ * Readers see either the old file or the complete new one, never a torn file.
+ * The temporary file is removed if the writer is destroyed without committing.
+ */
+class AtomicWriter {
+public:
+  /// @brief Creates the temporary file for @p target .
+  explicit AtomicWriter(filesystem::path target, const AtomicWriteOptions& options = {})
+      : target(std::move(target)), options(options) {
+    static std::atomic<unsigned> counter{0};
+    temporary = this->target;
+    temporary += ".tmp." + std::to_string(processId()) + "." + std::to_string(counter++);
+#ifdef COMMON613_ATOMIC_WRITER_POSIX
+    fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+    COMMON613_REQUIRE(fd >= 0, "Failed to create file: {}. Error code: {}.", temporary.string(), errno);
+    if (options.preallocate != 0) {
+      // The destructor does not run if the constructor throws, so the temporary file is discarded here.
+      try {
+        preallocate(options.preallocate);
+      } catch (...) {
+        closeFile();
+        std::remove(temporary.string().c_str());
+        throw;
+      }
+    }
+#else
+    file = open(temporary, "wb");
+#endif
+  }
+
+  AtomicWriter(const AtomicWriter&) = delete;
+  AtomicWriter& operator=(const AtomicWriter&) = delete;
+
+  /// @brief Discards the temporary file if not committed.
+  ~AtomicWriter() {
+    if (!committed) {
+      closeFile();
+      std::remove(temporary.string().c_str());
+    }
+  }
+
+  /// @brief Writes @p count data units from @p buffer , each sharing the size of @p T .
+  template <class T>
+  void write(const T* buffer, std::size_t count = 1) {
+    COMMON613_REQUIRE(!committed, "Writing to a committed file: {}.", target.string());
+    writeBytes(reinterpret_cast<const unsigned char*>(buffer), sizeof(T) * count);
+  }
+
+  /// @brief Returns the count of bytes written.
+  COMMON613_NODISCARD std::size_t size() const { return written; }
+
+  /**
+   * @brief Flushes the data and renames the temporary file into place.
+   *
+   * Nothing is renamed if any step fails, including closing, which may report delayed write errors.
+   */
+  void commit() {
+    COMMON613_REQUIRE(!committed, "File already committed: {}.", target.string());
+#ifdef COMMON613_ATOMIC_WRITER_POSIX
+    if (options.preallocate > written) {
+      COMMON613_REQUIRE(::ftruncate(fd, static_cast<off_t>(written)) == 0,
+                        "Failed to truncate file: {}. Error code: {}.", temporary.string(), errno);
+    }
+    if (options.durable) {
+      COMMON613_REQUIRE(syncData() == 0, "Failed to sync file: {}. Error code: {}.", temporary.string(), errno);
+    }
+#endif
+    COMMON613_REQUIRE(closeFile(), "Failed to close file: {}. Error code: {}.", temporary.string(), errno);
+    filesystem::rename(temporary, target);
+    committed = true;
+#ifdef COMMON613_ATOMIC_WRITER_POSIX
+    if (options.durable) {
+      syncDirectory();
+    }
+#endif
+  }
+
+private:
+  static long processId() {
+#ifdef COMMON613_ATOMIC_WRITER_POSIX
+    return static_cast<long>(::getpid());
+#else
+    return 0;
+#endif
+  }
+
+#ifdef COMMON613_ATOMIC_WRITER_POSIX
+  void preallocate(std::size_t bytes) {
+# ifdef __linux__
+    // Keeps the size at 0, so that an aborted write never leaves garbage readable at the end.
+    int ret = ::fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(bytes));
+    COMMON613_REQUIRE(ret == 0 || errno == EOPNOTSUPP || errno == ENOSYS,
+                      "Failed to preallocate file: {}. Error code: {}.", temporary.string(), errno);
+# else
+    (void) bytes;
+# endif
+  }
+
+  int syncData() {
+# if defined(__linux__)
+    return ::fdatasync(fd);
+# else
+    return ::fsync(fd);
+# endif
+  }
+
+  void syncDirectory() {
+    filesystem::path directory = target.parent_path();
+    int dirFd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_CLOEXEC);
+    COMMON613_REQUIRE(dirFd >= 0, "Failed to open directory: {}. Error code: {}.", directory.string(), errno);
+    int ret = ::fsync(dirFd);
+    ::close(dirFd);
+    COMMON613_REQUIRE(ret == 0, "Failed to sync directory: {}. Error code: {}.", directory.string(), errno);
+  }
+
+  // Starts writeback of newly written bytes, and waits for the previous window, bounding dirty pages to 2 windows.
+  void syncIncrementally() {
+# ifdef __linux__
+    if (options.syncInterval == 0 || written - flushing < options.syncInterval) {
+      return;
+    }
+    ::sync_file_range(fd, static_cast<off64_t>(flushing), static_cast<off64_t>(written - flushing),
+                      SYNC_FILE_RANGE_WRITE);
+    if (flushing > flushed) {
+      ::sync_file_range(fd, static_cast<off64_t>(flushed), static_cast<off64_t>(flushing - flushed),
+                        SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+    }
+    flushed = flushing;
+    flushing = written;
+# endif
+  }
+#endif
+
+  void writeBytes(const unsigned char* buffer, std::size_t bytes) {
+#ifdef COMMON613_ATOMIC_WRITER_POSIX
+    std::size_t done = 0;
+    while (done < bytes) {
+      ssize_t ret = ::write(fd, buffer + done, bytes - done);
+      if (ret < 0 && errno == EINTR) {
+        continue;
+      }
+      COMMON613_REQUIRE(ret > 0, "Failed to write file: {}. Error code: {}.", temporary.string(), errno);
+      done += static_cast<std::size_t>(ret);
+    }
+    written += bytes;
+    syncIncrementally();
+#else
+    file::write(file, buffer, bytes);
+    written += bytes;
+#endif
+  }
+
+  // Returns false if closing reports an error.
+  bool closeFile() {
+#ifdef COMMON613_ATOMIC_WRITER_POSIX
+    if (fd < 0) {
+      return true;
+    }
+    int ret = ::close(fd);
+    fd = -1;
+    return ret == 0;
+#else
+    FILE* pFile = file.release();
+    return pFile == nullptr || std::fclose(pFile) == 0;
+#endif
+  }
+
+  filesystem::path target;
+  filesystem::path temporary;
+  AtomicWriteOptions options;
+#ifdef COMMON613_ATOMIC_WRITER_POSIX
+  int fd = -1;
+  std::size_t flushed = 0;
+  std::size_t flushing = 0;
+#else
+  File file;
+#endif
+  std::size_t written = 0;
+  bool committed = false;
+};
+
+}
+
+}
+
+#endif //COMMON613_ATOMIC_WRITER_H
@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+/// @file
+/// @brief Detects x86 SIMD extensions enabled for the compiler, and provides portable bit scanning.
+
+#pragma once
+#ifndef COMMON613_COMPAT_SIMD_H
+#define COMMON613_COMPAT_SIMD_H
+
+#include <cstdint>
+
+/// @def COMMON613_HAS_SSE2
+/// @brief Defined as 1 if SSE2 intrinsics are usable, which is always the case on x86-64.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define COMMON613_HAS_SSE2 1
+# include <emmintrin.h>
+#endif
+
+/// @def COMMON613_HAS_SSSE3
+/// @brief Defined as 1 if SSSE3 intrinsics (e.g. @c pshufb ) are usable.
+#if defined(__SSSE3__) || defined(__AVX__)
+# define COMMON613_HAS_SSSE3 1
+# include <tmmintrin.h>
+#endif
+
+/// @def COMMON613_HAS_AVX2
+/// @brief Defined as 1 if AVX2 intrinsics are usable.
+#if defined(__AVX2__)
+# define COMMON613_HAS_AVX2 1
+# include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+# include <intrin.h>
+#endif
+
+namespace common613 {
+
+/// @cond
+namespace internal {
+
+// Index of the lowest set bit. mask must not be 0.
+inline unsigned countTrailingZeros(std::uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+}
+/// @endcond
+
+}
+
+#endif //COMMON613_COMPAT_SIMD_H
@@ -0,0 +1,25 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+/// @file
+/// @brief A utility to import C++17 @c std::string_view into C++14, with Boost.Utility as fallback.
+
+#pragma once
+#ifndef COMMON613_COMPAT_STRING_VIEW_H
+#define COMMON613_COMPAT_STRING_VIEW_H
+
+/// @typedef common613::string_view
+/// @brief An alias to @c std::string_view or @c boost::string_view according to C++ standards.
+#if __cplusplus >= 201703L
+# include <string_view>
+namespace common613 {
+using string_view = std::string_view;
+}
+#else
+# include <boost/utility/string_view.hpp>
+namespace common613 {
+using string_view = boost::string_view;
+}
+#endif
+
+#endif //COMMON613_COMPAT_STRING_VIEW_H
@@ -0,0 +1,389 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+/// @file
+/// @brief Streaming file I/O that bypasses (@c O_DIRECT) or drops (@c posix_fadvise) the page cache.
+
+#pragma once
+#ifndef COMMON613_DIRECT_IO_H
+#define COMMON613_DIRECT_IO_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <new>
+#include <string>
+#include <common613/assert.h>
+#include <common613/file_utils.h>
+#include <common613/memory.h>
+#include <common613/compat/cpp17.h>
+#include <common613/compat/file_system.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+# include <fcntl.h>
+# include <sys/stat.h>
+# include <unistd.h>
+# define COMMON613_DIRECT_IO_POSIX 1
+#endif
+
+namespace common613 {
+
+namespace file {
+
+/// @brief How @ref UncachedFile interacts with the page cache.
+enum class CacheMode {
+  /// @brief Plain buffered I/O.
+  normal,
+  /// @brief Buffered I/O, but written or consumed ranges are dropped from the cache with @c posix_fadvise.
+  dontCache,
+  /// @brief @c O_DIRECT I/O from aligned buffers. Falls back to @ref dontCache where it is unsupported.
+  direct,
+};
+
+/// @brief Access of @ref UncachedFile.
+enum class Access {
+  read,
+  write,
+};
+
+/**
+ * @brief Drops cached pages of @p file , after writing back its dirty data.
+ *
+ * A light way to stream through a @ref File without evicting the working sets of other processes.
+ * @note Does nothing where @c posix_fadvise is unavailable.
+ */
+inline void dropCache(const File& file) {
+  COMMON613_REQUIRE(std::fflush(file.get()) == 0, "Failed to flush file. Error code: {}.", errno);
+#if defined(COMMON613_DIRECT_IO_POSIX) && defined(POSIX_FADV_DONTNEED)
+  int fd = ::fileno(file.get());
+  ::fdatasync(fd);
+  ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+}
+
+/// @cond
+namespace internal {
+
+struct AlignedDeleter {
+  void operator()(unsigned char* p) const {
+    std::free(p);
+  }
+};
+
+using AlignedBuffer = std::unique_ptr<unsigned char[], AlignedDeleter>;
+
+// Without POSIX, O_DIRECT is never used, so the buffer needs no special alignment.
+inline AlignedBuffer allocateAligned(std::size_t size, std::size_t alignment) {
+  void* p = nullptr;
+#ifdef COMMON613_DIRECT_IO_POSIX
+  if (::posix_memalign(&p, alignment, size) != 0) {
+    p = nullptr;
+  }
+#else
+  (void) alignment;
+  p = std::malloc(size);
+#endif
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return AlignedBuffer(static_cast<unsigned char*>(p));
+}
+
+}
+/// @endcond
+
+/**
+ * @brief A file streamed sequentially in large blocks, without leaving its data in the page cache.
+ *
+ * In @ref CacheMode::direct, data move between the disk and an aligned block buffer with @c O_DIRECT,
+ * at aligned offsets. A last partial block is written padded with zeros, and the file is truncated to its real size.
+ * In @ref CacheMode::dontCache, each block is written back and dropped with @c posix_fadvise once done.
+ */
+class UncachedFile {
+public:
+  /// @brief Alignment of buffers, offsets and sizes for @c O_DIRECT, which covers common logical block sizes.
+  constexpr static const std::size_t alignment = 4096;
+  /// @brief Default size of blocks.
+  constexpr static const std::size_t defaultBlockSize = 1 << 20;
+
+  /**
+   * @brief Opens @p path , truncating it for @ref Access::write.
+   * @param blockSize Size of each transfer, rounded up to @ref alignment.
+   */
+  UncachedFile(filesystem::path path, Access access, CacheMode mode = CacheMode::direct,
+               std::size_t blockSize = defaultBlockSize)
+      : path(std::move(path)), access(access), cacheMode(mode),
+        blockSize(std::max<std::size_t>(1, (blockSize + alignment - 1) / alignment) * alignment),
+        buffer(internal::allocateAligned(this->blockSize, alignment)) {
+#ifdef COMMON613_DIRECT_IO_POSIX
+    int flags = access == Access::read ? O_RDONLY : (O_WRONLY | O_CREAT | O_TRUNC);
+    flags |= O_CLOEXEC;
+# ifdef O_DIRECT
+    if (cacheMode == CacheMode::direct) {
+      fd = ::open(this->path.c_str(), flags | O_DIRECT, 0666);
+    }
+# endif
+    if (fd < 0) {
+      // Some file systems, e.g. tmpfs, reject O_DIRECT.
+      if (cacheMode == CacheMode::direct) {
+        cacheMode = CacheMode::dontCache;
+      }
+      fd = ::open(this->path.c_str(), flags, 0666);
+    }
+    COMMON613_REQUIRE(fd >= 0, "Failed to open file: {}. Error code: {}.", this->path.string(), errno);
+# ifdef POSIX_FADV_SEQUENTIAL
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+# endif
+#else
+    cacheMode = CacheMode::normal;
+    file = open(this->path, access == Access::read ? "rb" : "wb");
+#endif
+  }
+
+  UncachedFile(const UncachedFile&) = delete;
+  UncachedFile& operator=(const UncachedFile&) = delete;
+
+  /// @brief Closes the file. Errors are swallowed, so call @ref close to have them reported.
+  ~UncachedFile() {
+    try {
+      close();
+    } catch (...) {
+    }
+  }
+
+  /// @brief Returns the effective mode, which may be weaker than requested.
+  COMMON613_NODISCARD CacheMode mode() const { return cacheMode; }
+
+  /// @brief Writes @p count data units from @p data , each sharing the size of @p T .
+  template <class T>
+  void write(const T* data, std::size_t count = 1) {
+    COMMON613_REQUIRE(access == Access::write && isOpen(), "File is not open for writing: {}.", path.string());
+    auto* bytes = reinterpret_cast<const unsigned char*>(data);
+    std::size_t size = sizeof(T) * count;
+    while (size != 0) {
+      std::size_t chunk = std::min(size, blockSize - bufferEnd);
+      std::memcpy(buffer.get() + bufferEnd, bytes, chunk);
+      bufferEnd += chunk;
+      bytes += chunk;
+      size -= chunk;
+      if (bufferEnd == blockSize) {
+        flushBlock(blockSize);
+      }
+    }
+  }
+
+  /// @brief Reads @p count data units of type @p T into @p data , throwing if the file ends first.
+  template <class T>
+  void read(T* data, std::size_t count = 1) {
+    std::size_t size = sizeof(T) * count;
+    std::size_t countRead = readBytes(reinterpret_cast<unsigned char*>(data), size);
+    COMMON613_REQUIRE(countRead == size, "Failed to read required count. Read: {}. Required: {}. File: {}.",
+                      countRead, size, path.string());
+  }
+
+  /// @brief Reads the rest of the file.
+  COMMON613_NODISCARD Memory readAll() {
+    Memory ret;
+    std::size_t countRead;
+    do {
+      std::size_t oldSize = ret.size();
+      ret.resize(oldSize + blockSize);
+      countRead = readBytes(ret.data() + oldSize, blockSize);
+      ret.resize(oldSize + countRead);
+    } while (countRead == blockSize);
+    return ret;
+  }
+
+  /**
+   * @brief Writes out pending data and closes the file. Does nothing if already closed.
+   *
+   * The file is closed even if writing out fails, and the failure is rethrown afterwards.
+   */
+  void close() {
+    if (!isOpen()) {
+      return;
+    }
+    std::exception_ptr failure;
+    if (access == Access::write) {
+      try {
+        finishWriting();
+      } catch (...) {
+        failure = std::current_exception();
+      }
+    }
+#ifdef COMMON613_DIRECT_IO_POSIX
+# ifdef POSIX_FADV_DONTNEED
+    if (cacheMode != CacheMode::normal) {
+      if (access == Access::write && cacheMode == CacheMode::dontCache) {
+        // Writeback of the last block was only started, and dirty pages are not dropped.
+        ::fdatasync(fd);
+      }
+      ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    }
+# endif
+    ::close(fd);
+    fd = -1;
+#else
+    file.reset();
+#endif
+    if (failure) {
+      std::rethrow_exception(failure);
+    }
+  }
+
+private:
+  bool isOpen() const {
+#ifdef COMMON613_DIRECT_IO_POSIX
+    return fd >= 0;
+#else
+    return file != nullptr;
+#endif
+  }
+
+  // Transfers exactly size bytes of the buffer to or from offset of the file, unless the file ends when reading.
+  std::size_t transfer(std::size_t offset, std::size_t size) {
+#ifdef COMMON613_DIRECT_IO_POSIX
+    std::size_t done = 0;
+    while (done < size) {
+      ssize_t ret = access == Access::read
+          ? ::pread(fd, buffer.get() + done, size - done, static_cast<off_t>(offset + done))
+          : ::pwrite(fd, buffer.get() + done, size - done, static_cast<off_t>(offset + done));
+      if (ret < 0 && errno == EINTR) {
+        continue;
+      }
+      COMMON613_REQUIRE(ret >= 0, "Failed to {} file: {}. Error code: {}.",
+                        access == Access::read ? "read" : "write", path.string(), errno);
+      if (ret == 0) {
+        break;
+      }
+      done += static_cast<std::size_t>(ret);
+    }
+    return done;
+#else
+    (void) offset;
+    return access == Access::read ? std::fread(buffer.get(), 1, size, file.get())
+                                  : std::fwrite(buffer.get(), 1, size, file.get());
+#endif
+  }
+
+  // Drops [offset, offset + size) from the cache, waiting for its writeback first.
+  void dropRange(std::size_t offset, std::size_t size) {
+#if defined(COMMON613_DIRECT_IO_POSIX) && defined(POSIX_FADV_DONTNEED)
+    if (cacheMode != CacheMode::dontCache) {
+      return;
+    }
+# ifdef __linux__
+    if (access == Access::write) {
+      ::sync_file_range(fd, static_cast<off64_t>(offset), static_cast<off64_t>(size),
+                        SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+    }
+# endif
+    ::posix_fadvise(fd, static_cast<off_t>(offset), static_cast<off_t>(size), POSIX_FADV_DONTNEED);
+#else
+    (void) offset;
+    (void) size;
+#endif
+  }
+
+  void flushBlock(std::size_t size) {
+    std::size_t written = transfer(fileOffset, size);
+    COMMON613_REQUIRE(written == size, "Failed to write file: {}. Written: {}. Required: {}.",
+                      path.string(), written, size);
+#ifdef __linux__
+    if (cacheMode == CacheMode::dontCache) {
+      // Starts writeback of this block now, and drops the previous one, whose writeback is likely done.
+      ::sync_file_range(fd, static_cast<off64_t>(fileOffset), static_cast<off64_t>(size), SYNC_FILE_RANGE_WRITE);
+    }
+#endif
+    if (fileOffset != 0) {
+      dropRange(fileOffset - blockSize, blockSize);
+    }
+    fileOffset += size;
+    bufferEnd = 0;
+  }
+
+  void finishWriting() {
+    std::size_t tail = bufferEnd;
+    if (tail == 0) {
+      return;
+    }
+    if (cacheMode != CacheMode::direct) {
+      flushBlock(tail);
+      return;
+    }
+#ifdef COMMON613_DIRECT_IO_POSIX
+    // O_DIRECT only writes whole aligned blocks, so the tail is padded and the padding truncated afterwards.
+    std::size_t padded = (tail + alignment - 1) / alignment * alignment;
+    std::memset(buffer.get() + tail, 0, padded - tail);
+    flushBlock(padded);
+    fileOffset -= padded - tail;
+    COMMON613_REQUIRE(::ftruncate(fd, static_cast<off_t>(fileOffset)) == 0,
+                      "Failed to truncate file: {}. Error code: {}.", path.string(), errno);
+#endif
+  }
+
+  std::size_t readBytes(unsigned char* data, std::size_t size) {
+    COMMON613_REQUIRE(access == Access::read && isOpen(), "File is not open for reading: {}.", path.string());
+    std::size_t done = 0;
+    while (done < size) {
+      if (bufferBegin == bufferEnd) {
+        if (eof) {
+          break;
+        }
+        if (fileOffset != 0) {
+          dropRange(fileOffset - blockSize, blockSize);
+        }
+        bufferBegin = 0;
+        bufferEnd = transfer(fileOffset, blockSize);
+        fileOffset += bufferEnd;
+        eof = bufferEnd < blockSize;
+        continue;
+      }
+      std::size_t chunk = std::min(size - done, bufferEnd - bufferBegin);
+      std::memcpy(data + done, buffer.get() + bufferBegin, chunk);
+      bufferBegin += chunk;
+      done += chunk;
+    }
+    return done;
+  }
+
+  filesystem::path path;
+  Access access;
+  CacheMode cacheMode;
+  std::size_t blockSize;
+  internal::AlignedBuffer buffer;
+  // Data in the buffer are in [bufferBegin, bufferEnd), and the buffer starts at fileOffset when writing.
+  std::size_t bufferBegin = 0;
+  std::size_t bufferEnd = 0;
+  std::size_t fileOffset = 0;
+  bool eof = false;
+#ifdef COMMON613_DIRECT_IO_POSIX
+  int fd = -1;
+#else
+  File file;
+#endif
+};
+
+/// @brief Reads the whole file at @p path in @p mode , e.g. to stream it once without polluting the page cache.
+COMMON613_NODISCARD inline Memory readAll(const filesystem::path& path, CacheMode mode) {
+  UncachedFile file(path, Access::read, mode);
+  return file.readAll();
+}
+
+/// @brief Writes @p count data units from @p data to the file at @p path in @p mode , replacing its content.
+template <class T>
+void writeAll(const filesystem::path& path, const T* data, std::size_t count, CacheMode mode) {
+  UncachedFile file(path, Access::write, mode);
+  file.write(data, count);
+  file.close();
+}
+
+}
+
+}
+
+#endif //COMMON613_DIRECT_IO_H
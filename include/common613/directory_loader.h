@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+/// @file
+/// @brief Loads all files in a directory concurrently into a single contiguous @ref UninitializedMemory block.
+
+#pragma once
+#ifndef COMMON613_DIRECTORY_LOADER_H
+#define COMMON613_DIRECTORY_LOADER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <common613/assert.h>
+#include <common613/file_utils.h>
+#include <common613/memory.h>
+#include <common613/thread_pool.h>
+#include <common613/compat/cpp17.h>
+#include <common613/compat/file_system.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+# include <cerrno>
+# include <fcntl.h>
+# include <sys/stat.h>
+# include <unistd.h>
+# define COMMON613_DIRECTORY_LOADER_POSIX 1
+#endif
+
+namespace common613 {
+
+namespace file {
+
+/// @brief Options for @ref loadDirectory.
+struct DirectoryLoadOptions {
+  /// @brief Whether to walk into subdirectories.
+  bool recursive = false;
+  /// @brief Regular files are loaded only if @c filter returns @c true for them. Empty to load all.
+  std::function<bool(const filesystem::path&)> filter;
+  /// @brief Pool to read files with, or @c nullptr for @ref ThreadPool::instance().
+  ThreadPool* pool = nullptr;
+  /// @brief Count of files per task.
+  std::size_t grain = 16;
+};
+
+/// @brief A file loaded by @ref loadDirectory.
+struct LoadedFile {
+  /// @brief Path of the file.
+  filesystem::path path;
+  /// @brief Offset of its content in @ref LoadedDirectory::data.
+  std::size_t offset;
+  /// @brief Size of its content.
+  std::size_t size;
+};
+
+/// @brief Contents of files loaded by @ref loadDirectory, stored back to back.
+struct LoadedDirectory {
+  /// @brief Contents of all files. Bytes past the end of a file shrinking during loading are left uninitialized.
+  UninitializedMemory data;
+  /// @brief Index of files, in the order they are laid out in @ref data.
+  std::vector<LoadedFile> files;
+
+  /// @brief Returns the content of the @p index -th file.
+  COMMON613_NODISCARD const unsigned char* content(std::size_t index) const {
+    return data.data() + files[index].offset;
+  }
+};
+
+}
+
+/// @cond
+namespace internal {
+
+struct DirectoryEntry {
+  filesystem::path path;
+  std::uintmax_t inode;
+  std::size_t size;
+};
+
+inline void statEntry(DirectoryEntry& entry) {
+#ifdef COMMON613_DIRECTORY_LOADER_POSIX
+  struct stat status;
+  COMMON613_REQUIRE(::stat(entry.path.c_str(), &status) == 0, "Failed to stat file: {}.", entry.path.string());
+  entry.inode = status.st_ino;
+  entry.size = static_cast<std::size_t>(status.st_size);
+#else
+  entry.inode = 0;
+  entry.size = static_cast<std::size_t>(filesystem::file_size(entry.path));
+#endif
+}
+
+// Reads at most size bytes into buffer, and returns the count of bytes read.
+inline std::size_t readEntry(const filesystem::path& path, unsigned char* buffer, std::size_t size) {
+#ifdef COMMON613_DIRECTORY_LOADER_POSIX
+  int fd = ::open(path.c_str(), O_RDONLY);
+  COMMON613_REQUIRE(fd >= 0, "Failed to open file: {}. Please check it again.", path.string());
+  std::size_t total = 0;
+  int error = 0;
+  while (total < size) {
+    ssize_t ret = ::read(fd, buffer + total, size - total);
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret < 0) {
+      error = errno;
+      break;
+    }
+    if (ret == 0) {
+      break;
+    }
+    total += static_cast<std::size_t>(ret);
+  }
+  ::close(fd);
+  COMMON613_REQUIRE(error == 0, "Failed to read file: {}. Error code: {}.", path.string(), error);
+  return total;
+#else
+  file::File file = file::open(path, "rb");
+  return file::read(file, buffer, std::nothrow, size);
+#endif
+}
+
+template <class DirectoryIterator>
+void collectEntries(const filesystem::path& directory, const file::DirectoryLoadOptions& options,
+                    std::vector<DirectoryEntry>& entries) {
+  for (const auto& item : DirectoryIterator(directory)) {
+    if (filesystem::is_regular_file(item.status()) && (!options.filter || options.filter(item.path()))) {
+      entries.push_back(DirectoryEntry{item.path(), 0, 0});
+    }
+  }
+}
+
+}
+/// @endcond
+
+namespace file {
+
+/**
+ * @brief Loads all regular files under @p directory into one contiguous block.
+ *
+ * Files are stat-ed and read concurrently on a @ref ThreadPool. They are read and laid out in inode order,
+ * which usually follows their placement on disk, so that reads stay local.
+ * Files shrinking during loading keep their new size in the index.
+ */
+COMMON613_NODISCARD inline LoadedDirectory loadDirectory(const filesystem::path& directory,
+                                                         const DirectoryLoadOptions& options = {}) {
+  COMMON613_REQUIRE(filesystem::is_directory(directory), "Not a directory: {}.", directory.string());
+  ThreadPool& pool = options.pool != nullptr ? *options.pool : ThreadPool::instance();
+
+  std::vector<internal::DirectoryEntry> entries;
+  if (options.recursive) {
+    internal::collectEntries<filesystem::recursive_directory_iterator>(directory, options, entries);
+  } else {
+    internal::collectEntries<filesystem::directory_iterator>(directory, options, entries);
+  }
+  parallelFor(pool, 0, entries.size(), [&entries](std::size_t i) { internal::statEntry(entries[i]); },
+              options.grain);
+  std::sort(entries.begin(), entries.end(), [](const internal::DirectoryEntry& lhs,
+                                               const internal::DirectoryEntry& rhs) {
+    return lhs.inode != rhs.inode ? lhs.inode < rhs.inode : lhs.path < rhs.path;
+  });
+
+  LoadedDirectory ret;
+  ret.files.reserve(entries.size());
+  std::size_t total = 0;
+  for (const auto& entry : entries) {
+    ret.files.push_back(LoadedFile{entry.path, total, entry.size});
+    total += entry.size;
+  }
+  // Every byte is overwritten by the reads, so the block is not zero-filled first.
+  ret.data.resize(total);
+  parallelFor(pool, 0, ret.files.size(), [&ret](std::size_t i) {
+    LoadedFile& file = ret.files[i];
+    file.size = internal::readEntry(file.path, ret.data.data() + file.offset, file.size);
+  }, options.grain);
+  return ret;
+}
+
+}
+
+}
+
+#endif //COMMON613_DIRECTORY_LOADER_H
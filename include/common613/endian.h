@@ -0,0 +1,295 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+/// @file
+/// @brief Byte order conversion for binary-usable structs, described field by field at compile time.
+
+#pragma once
+#ifndef COMMON613_ENDIAN_H
+#define COMMON613_ENDIAN_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include <common613/assert.h>
+#include <common613/file_utils.h>
+#include <common613/struct_size_check.h>
+#include <common613/compat/cpp17.h>
+#include <common613/compat/simd.h>
+#include <common613/vector_definitions.h>
+
+namespace common613 {
+
+/// @brief Byte orders, like C++20 @c std::endian.
+enum class Endian {
+  little,
+  big,
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  native = big,
+#else
+  native = little,
+#endif
+};
+
+/// @brief Reverses the bytes of an integer.
+template <class IntT>
+COMMON613_NODISCARD
+constexpr IntT byteSwap(IntT value) {
+  static_assert(std::is_integral<IntT>::value, "byteSwap is only for integers.");
+  using UIntT = std::make_unsigned_t<IntT>;
+  auto bits = static_cast<UIntT>(value);
+  UIntT ret = 0;
+  for (std::size_t i = 0; i < sizeof(IntT); ++i) {
+    ret = static_cast<UIntT>((ret << 8) | ((bits >> (i * 8)) & 0xFF));
+  }
+  return static_cast<IntT>(ret);
+}
+
+/// @brief Describes a field of @ref EndianFields, holding @p Count scalars of @p ElementSize bytes at @p Offset.
+template <std::size_t Offset, std::size_t ElementSize, std::size_t Count>
+struct EndianField {};
+
+/// @cond
+namespace internal {
+
+struct EndianFieldInfo {
+  std::size_t offset;
+  std::size_t elementSize;
+  std::size_t count;
+};
+
+template <class T, class Enabled = void>
+struct EndianScalar {
+  static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                "Endian fields must be scalars, arrays of scalars, or ArrNi.");
+  using type = T;
+};
+
+template <class T, std::size_t N>
+struct EndianScalar<T[N]> : EndianScalar<T> {};
+
+template <class T, std::size_t N>
+struct EndianScalar<std::array<T, N>> : EndianScalar<T> {};
+
+template <bool Vec, class IntT, std::size_t N>
+struct EndianScalar<ArrNi<Vec, IntT, N>> : EndianScalar<IntT> {};
+
+template <std::size_t Size>
+struct UIntOfSize;
+template <> struct UIntOfSize<1> { using type = std::uint8_t; };
+template <> struct UIntOfSize<2> { using type = std::uint16_t; };
+template <> struct UIntOfSize<4> { using type = std::uint32_t; };
+template <> struct UIntOfSize<8> { using type = std::uint64_t; };
+
+template <std::size_t ElementSize>
+inline void swapElements(unsigned char* bytes, std::size_t count) {
+  using UIntT = typename UIntOfSize<ElementSize>::type;
+  for (std::size_t i = 0; i < count; ++i) {
+    UIntT value;
+    std::memcpy(&value, bytes + i * ElementSize, ElementSize);
+    value = byteSwap(value);
+    std::memcpy(bytes + i * ElementSize, &value, ElementSize);
+  }
+}
+
+template <std::size_t Size>
+struct BytePermutation {
+  unsigned char source[Size];
+};
+
+}
+/// @endcond
+
+/// @def COMMON613_ENDIAN_FIELD
+/// @brief Declares @p member of @p Struct as an @ref EndianField, see @ref EndianLayout.
+#define COMMON613_ENDIAN_FIELD(Struct, member) \
+  ::common613::EndianField<offsetof(Struct, member), \
+      sizeof(typename ::common613::internal::EndianScalar<decltype(Struct::member)>::type), \
+      sizeof(decltype(Struct::member)) / \
+      sizeof(typename ::common613::internal::EndianScalar<decltype(Struct::member)>::type)>
+
+/// @brief Lists fields of a struct whose bytes are to be reversed, for @ref EndianLayout.
+template <class... Fields>
+struct EndianFields;
+
+template <std::size_t... Offset, std::size_t... ElementSize, std::size_t... Count>
+struct EndianFields<EndianField<Offset, ElementSize, Count>...> {
+  /// @brief Count of fields.
+  constexpr static const std::size_t size = sizeof...(Offset);
+
+  /// @brief Reverses bytes of each field in the record at @p record .
+  static void swap(unsigned char* record) {
+    int expand[] = {0, (internal::swapElements<ElementSize>(record + Offset, Count), 0)...};
+    (void) expand;
+  }
+
+  /// @brief Returns where each byte of a record comes from after swapping.
+  template <std::size_t Size>
+  constexpr static internal::BytePermutation<Size> permutation() {
+    internal::BytePermutation<Size> ret{};
+    for (std::size_t i = 0; i < Size; ++i) {
+      ret.source[i] = static_cast<unsigned char>(i);
+    }
+    const internal::EndianFieldInfo fields[] = {internal::EndianFieldInfo{0, 1, 0},
+                                                internal::EndianFieldInfo{Offset, ElementSize, Count}...};
+    for (const internal::EndianFieldInfo& field : fields) {
+      for (std::size_t e = 0; e < field.count; ++e) {
+        for (std::size_t b = 0; b < field.elementSize; ++b) {
+          std::size_t base = field.offset + e * field.elementSize;
+          ret.source[base + b] = static_cast<unsigned char>(base + field.elementSize - 1 - b);
+        }
+      }
+    }
+    return ret;
+  }
+};
+
+/**
+ * @brief Describes which bytes of @p T are reversed to change its byte order.
+ *
+ * Arithmetic types, enums and @ref ArrNi are described already. For a binary-usable struct,
+ * specialize it in namespace @c common613 with the fields to convert, and leave out byte-sized or opaque fields:
+ * @code
+ * struct Header {
+ *   std::uint32_t magic;
+ *   std::uint16_t version;
+ *   char tag[2];
+ *   common613::ArrNi<false, std::int32_t, 2> origin;
+ *   COMMON613_INJECT_SIZE_FIELD(16);
+ * };
+ * COMMON613_CHECK_BINARY_USABLE(Header);
+ *
+ * namespace common613 {
+ * template <>
+ * struct EndianLayout<Header> : EndianFields<COMMON613_ENDIAN_FIELD(Header, magic),
+ *                                            COMMON613_ENDIAN_FIELD(Header, version),
+ *                                            COMMON613_ENDIAN_FIELD(Header, origin)> {};
+ * }
+ * @endcode
+ */
+template <class T, class Enabled = void>
+struct EndianLayout {
+  static_assert(sizeof(T) == 0, "Please specialize EndianLayout for this type.");
+};
+
+/// @cond
+template <class T>
+struct EndianLayout<T, std::enable_if_t<std::is_arithmetic<T>::value || std::is_enum<T>::value>>
+    : EndianFields<EndianField<0, sizeof(T), 1>> {};
+
+template <bool Vec, class IntT, std::size_t N>
+struct EndianLayout<ArrNi<Vec, IntT, N>> : EndianFields<EndianField<0, sizeof(IntT), N>> {};
+/// @endcond
+
+/// @cond
+namespace internal {
+
+template <class T, class Enabled = void>
+struct HasInjectedSize : std::false_type {};
+
+template <class T>
+struct HasInjectedSize<T, std::enable_if_t<T::COMMON613_INJECTED_SIZE != 0>> : std::true_type {};
+
+// Byte shuffle mask applying the permutation of T to every record in a 16-byte lane.
+template <class T>
+constexpr BytePermutation<16> laneShuffle() {
+  constexpr BytePermutation<sizeof(T)> record = EndianLayout<T>::template permutation<sizeof(T)>();
+  BytePermutation<16> ret{};
+  for (std::size_t i = 0; i < 16; ++i) {
+    ret.source[i] = static_cast<unsigned char>(i / sizeof(T) * sizeof(T) + record.source[i % sizeof(T)]);
+  }
+  return ret;
+}
+
+template <class T>
+void swapRecords(T* records, std::size_t count, std::false_type) {
+  auto* bytes = reinterpret_cast<unsigned char*>(records);
+  for (std::size_t i = 0; i < count; ++i) {
+    EndianLayout<T>::swap(bytes + i * sizeof(T));
+  }
+}
+
+// Records tiling 16-byte lanes are permuted a whole lane (or two with AVX2) per pshufb.
+template <class T>
+void swapRecords(T* records, std::size_t count, std::true_type) {
+  std::size_t i = 0;
+#ifdef COMMON613_HAS_SSSE3
+  auto* bytes = reinterpret_cast<unsigned char*>(records);
+  const std::size_t totalBytes = count * sizeof(T);
+  static constexpr BytePermutation<16> shuffle = laneShuffle<T>();
+  const __m128i mask16 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffle.source));
+  std::size_t offset = 0;
+# ifdef COMMON613_HAS_AVX2
+  const __m256i mask32 = _mm256_broadcastsi128_si256(mask16);
+  for (; offset + 32 <= totalBytes; offset += 32) {
+    __m256i* p = reinterpret_cast<__m256i*>(bytes + offset);
+    _mm256_storeu_si256(p, _mm256_shuffle_epi8(_mm256_loadu_si256(p), mask32));
+  }
+# endif
+  for (; offset + 16 <= totalBytes; offset += 16) {
+    __m128i* p = reinterpret_cast<__m128i*>(bytes + offset);
+    _mm_storeu_si128(p, _mm_shuffle_epi8(_mm_loadu_si128(p), mask16));
+  }
+  i = offset / sizeof(T);
+#endif
+  swapRecords(records + i, count - i, std::false_type{});
+}
+
+}
+/// @endcond
+
+/**
+ * @brief Reverses the byte order of @p count records at @p records in place, as described by @ref EndianLayout.
+ * @note Records of 1, 2, 4, 8 or 16 bytes are shuffled 16 or 32 bytes at a time with SSSE3/AVX2.
+ */
+template <class T>
+void swapEndian(T* records, std::size_t count) {
+  static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be byte-swapped.");
+  static_assert(!std::is_class<T>::value || internal::HasInjectedSize<T>::value,
+                "Structs should be checked with COMMON613_CHECK_BINARY_USABLE.");
+  internal::swapRecords(records, count, std::integral_constant<bool, 16 % sizeof(T) == 0>{});
+}
+
+/// @brief Converts @p count records between host byte order and @p Order in place. No-op if they are the same.
+template <Endian Order, class T>
+void convertEndian(T* records, std::size_t count) {
+  COMMON613_CONSTEXPR_IF(Order != Endian::native) {
+    swapEndian(records, count);
+  }
+}
+
+namespace file {
+
+/// @brief Writes @p count records to @p file in byte order @p Order, converting in chunks when needed.
+template <Endian Order, class T>
+void writeAs(const File& file, const T* buffer, std::size_t count = 1) {
+  COMMON613_CONSTEXPR_IF(Order == Endian::native) {
+    write(file, buffer, count);
+  } else {
+    constexpr std::size_t chunkCount = (1 << 16) / sizeof(T) + 1;
+    std::vector<T> chunk(std::min(count, chunkCount));
+    for (std::size_t done = 0; done < count; done += chunk.size()) {
+      std::size_t size = std::min(count - done, chunk.size());
+      std::memcpy(chunk.data(), buffer + done, size * sizeof(T));
+      swapEndian(chunk.data(), size);
+      write(file, chunk.data(), size);
+    }
+  }
+}
+
+/// @brief Reads @p count records in byte order @p Order from @p file , and converts them into host byte order.
+template <Endian Order, class T>
+void readAs(const File& file, T* buffer, std::size_t count = 1) {
+  read(file, buffer, count);
+  convertEndian<Order>(buffer, count);
+}
+
+}
+
+}
+
+#endif //COMMON613_ENDIAN_H
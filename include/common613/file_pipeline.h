@@ -0,0 +1,234 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+/// @file
+/// @brief A bounded read/parse/collect pipeline over a @ref File, overlapping I/O with parsing.
+
+#pragma once
+#ifndef COMMON613_FILE_PIPELINE_H
+#define COMMON613_FILE_PIPELINE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <common613/assert.h>
+#include <common613/file_utils.h>
+#include <common613/memory.h>
+#include <common613/ring_queue.h>
+#include <common613/thread_pool.h>
+#include <common613/compat/cpp17.h>
+
+namespace common613 {
+
+/// @cond
+namespace internal {
+
+// Buffers stay blockSize bytes long, and size counts the bytes read into them.
+struct PipelineBlock {
+  std::size_t index = 0;
+  Memory data;
+  std::size_t size = 0;
+};
+
+template <class Result>
+struct PipelineParsed {
+  std::size_t index = 0;
+  Memory data;
+  Result result{};
+};
+
+// State shared by the stages. The first exception thrown by any stage stops all of them.
+struct PipelineControl {
+  constexpr static const std::size_t unknown = std::numeric_limits<std::size_t>::max();
+
+  std::atomic<bool> failed{false};
+  std::atomic<std::size_t> blockCount{unknown};
+  std::mutex mutex;
+  std::exception_ptr exception;
+
+  void fail(std::exception_ptr e) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!exception) {
+      exception = std::move(e);
+    }
+    failed.store(true, std::memory_order_release);
+  }
+
+  bool stopped() const {
+    return failed.load(std::memory_order_acquire);
+  }
+};
+
+// Pushes value, waiting while the queue is full. Returns false if the pipeline failed meanwhile.
+template <class Queue, class T>
+bool pushWaiting(Queue& queue, T&& value, const PipelineControl& control) {
+  Backoff backoff;
+  while (!queue.tryPush(std::move(value))) {
+    if (control.stopped()) {
+      return false;
+    }
+    backoff.pause();
+  }
+  return true;
+}
+
+}
+/// @endcond
+
+namespace file {
+
+/// @brief Options for @ref runPipeline.
+struct PipelineOptions {
+  /// @brief Bytes read into each block. Make it a multiple of the record size for fixed-size records.
+  std::size_t blockSize = 1 << 20;
+  /// @brief Count of parser threads. 0 for one per hardware thread, less one for the reader.
+  std::size_t parsers = 0;
+  /// @brief Count of blocks being read, parsed or waiting for collection at once. 0 for twice the parsers.
+  std::size_t blocksInFlight = 0;
+};
+
+/**
+ * @brief Reads @p file in blocks on one thread, parses blocks on several threads, and collects results in order.
+ *
+ * Call as @c runPipeline(file,parse,collect) , where @c parse(const unsigned char*data,std::size_t size,
+ * std::size_t index) returns a result for the @c size bytes of a block on a parser thread, and
+ * @c collect(Result&&result,std::size_t index) receives results in the order of blocks on the calling thread.
+ * Blocks are @c blockSize bytes except the last one, and records crossing blocks are not joined.
+ *
+ * Blocks travel through lock-free ring queues. Their buffers are allocated once at @c blockSize bytes and recycled
+ * after collection without being cleared, so at most @c blocksInFlight blocks are held, and a slow stage holds back
+ * the others.
+ * The first exception thrown by @p parse , @p collect or reading stops the pipeline and is rethrown.
+ * @tparam Result Type returned by @p parse , which must be default-constructible and movable.
+ */
+template <class Parse, class Collect>
+void runPipeline(const File& file, Parse parse, Collect collect, const PipelineOptions& options = {}) {
+  using Result = std::decay_t<decltype(parse(std::declval<const unsigned char*>(), std::size_t{}, std::size_t{}))>;
+  using Parsed = internal::PipelineParsed<Result>;
+  const std::size_t blockSize = std::max<std::size_t>(1, options.blockSize);
+  const std::size_t parserCount = options.parsers != 0
+      ? options.parsers : std::max<std::size_t>(1, ThreadPool::defaultThreadCount() - 1);
+  const std::size_t inFlight = std::max(options.blocksInFlight != 0 ? options.blocksInFlight : 2 * parserCount,
+                                        std::size_t{2});
+
+  internal::PipelineControl control;
+  SpscQueue<Memory> freeBuffers(inFlight);
+  MpmcQueue<internal::PipelineBlock> blocks(inFlight + parserCount);
+  MpmcQueue<Parsed> parsed(inFlight);
+  for (std::size_t i = 0; i < inFlight; ++i) {
+    (void) freeBuffers.tryPush(Memory(blockSize));
+  }
+
+  std::thread reader([&] {
+    try {
+      std::size_t index = 0;
+      Memory buffer;
+      internal::Backoff backoff;
+      while (!control.stopped()) {
+        if (!freeBuffers.tryPop(buffer)) {
+          backoff.pause();
+          continue;
+        }
+        backoff.reset();
+        std::size_t countRead = read(file, buffer.data(), std::nothrow, blockSize);
+        COMMON613_REQUIRE(countRead == blockSize || !std::ferror(file.get()),
+                          "Failed to read block {}. Error code: {}.", index, std::ferror(file.get()));
+        if (countRead == 0) {
+          break;
+        }
+        if (!internal::pushWaiting(blocks, internal::PipelineBlock{index++, std::move(buffer), countRead}, control)) {
+          return;
+        }
+        if (countRead < blockSize) {
+          break;
+        }
+      }
+      control.blockCount.store(index, std::memory_order_release);
+    } catch (...) {
+      control.fail(std::current_exception());
+    }
+    // Marks the end for each parser.
+    for (std::size_t i = 0; i < parserCount; ++i) {
+      internal::pushWaiting(blocks, internal::PipelineBlock{internal::PipelineControl::unknown, Memory(), 0}, control);
+    }
+  });
+
+  std::vector<std::thread> parsers;
+  parsers.reserve(parserCount);
+  for (std::size_t p = 0; p < parserCount; ++p) {
+    parsers.emplace_back([&] {
+      try {
+        internal::PipelineBlock block;
+        internal::Backoff backoff;
+        while (!control.stopped()) {
+          if (!blocks.tryPop(block)) {
+            backoff.pause();
+            continue;
+          }
+          backoff.reset();
+          if (block.index == internal::PipelineControl::unknown) {
+            return;
+          }
+          Result result = parse(static_cast<const unsigned char*>(block.data.data()), block.size, block.index);
+          if (!internal::pushWaiting(parsed, Parsed{block.index, std::move(block.data), std::move(result)}, control)) {
+            return;
+          }
+        }
+      } catch (...) {
+        control.fail(std::current_exception());
+      }
+    });
+  }
+
+  // Collects on this thread, reordering results in slots indexed modulo inFlight,
+  // which is safe as at most inFlight blocks are out.
+  try {
+    std::vector<Parsed> slots(inFlight);
+    std::vector<unsigned char> ready(inFlight, 0);
+    std::size_t next = 0;
+    Parsed item;
+    internal::Backoff backoff;
+    while (!control.stopped() && next < control.blockCount.load(std::memory_order_acquire)) {
+      if (ready[next % inFlight]) {
+        Parsed& slot = slots[next % inFlight];
+        ready[next % inFlight] = 0;
+        collect(std::move(slot.result), next);
+        (void) freeBuffers.tryPush(std::move(slot.data));
+        ++next;
+        continue;
+      }
+      if (!parsed.tryPop(item)) {
+        backoff.pause();
+        continue;
+      }
+      backoff.reset();
+      std::size_t slot = item.index % inFlight;
+      slots[slot] = std::move(item);
+      ready[slot] = 1;
+    }
+  } catch (...) {
+    control.fail(std::current_exception());
+  }
+
+  reader.join();
+  for (std::thread& parser : parsers) {
+    parser.join();
+  }
+  if (control.exception) {
+    std::rethrow_exception(control.exception);
+  }
+}
+
+}
+
+}
+
+#endif //COMMON613_FILE_PIPELINE_H
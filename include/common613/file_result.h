@@ -0,0 +1,369 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+/// @file
+/// @brief Exception-free variants of the @ref File functions, returning results with the captured errors.
+
+#pragma once
+#ifndef COMMON613_FILE_RESULT_H
+#define COMMON613_FILE_RESULT_H
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <fmt/format.h>
+#include <common613/assert.h>
+#include <common613/file_utils.h>
+#include <common613/memory.h>
+#include <common613/compat/cpp17.h>
+#include <common613/compat/file_system.h>
+
+namespace common613 {
+
+namespace file {
+
+/// @brief Operations that may fail in the @c try* functions.
+enum class Operation : unsigned char {
+  open,
+  read,
+  write,
+  seek,
+  tell,
+};
+
+/**
+ * @brief Describes a failed file operation.
+ *
+ * Only @c errno , counts and the path are captured when the error happens, without allocation.
+ * Text is formatted by @ref message on request.
+ */
+struct Error {
+  /// @brief Capacity of @ref path, including the terminating null character.
+  constexpr static const std::size_t pathCapacity = 256;
+
+  /// @brief The operation that failed.
+  Operation operation = Operation::open;
+  /// @brief @c errno after the failure, or @c 0 if a read stopped at the end of file.
+  int code = 0;
+  /// @brief Count of units transferred before the failure.
+  std::size_t done = 0;
+  /// @brief Count of units requested.
+  std::size_t required = 0;
+  /**
+   * @brief The path passed to @c tryOpen for failures of @c open, empty otherwise.
+   *
+   * It is stored inline, and longer paths are cut to end with "...". It is empty for wide @c filesystem::path .
+   */
+  char path[pathCapacity] = {};
+
+  /// @brief Returns @ref code as a @c std::error_code.
+  COMMON613_NODISCARD std::error_code errorCode() const {
+    return {code, std::generic_category()};
+  }
+
+  /// @brief Formats a human-readable description, e.g. for logging.
+  COMMON613_NODISCARD std::string message() const {
+    static const char* const names[] = {"open", "read", "write", "seek", "tell"};
+    const char* name = names[static_cast<unsigned char>(operation)];
+    const char* reason = code == 0 ? "end of file" : std::strerror(code);
+    if (operation == Operation::open) {
+      return fmt::format("Failed to open file: {}. {}. Error code: {}.", path, reason, code);
+    }
+    if (operation == Operation::read || operation == Operation::write) {
+      return fmt::format("Failed to {} required count. Done: {}. Required: {}. {}. Error code: {}.",
+                         name, done, required, reason, code);
+    }
+    return fmt::format("Failed to {} in file. {}. Error code: {}.", name, reason, code);
+  }
+};
+
+/**
+ * @brief Either a value of @p T or an @ref Error, like C++23 @c std::expected.
+ *
+ * Only the held alternative is constructed. Testing it costs a branch.
+ * Use @ref value to get the value, which throws like the checked functions on failure.
+ * @p T must be nothrow move-constructible, so that assignment never leaves it holding nothing.
+ */
+template <class T>
+class Result {
+  static_assert(std::is_nothrow_move_constructible<T>::value, "Result requires a nothrow move constructor.");
+
+public:
+  /// @brief Holds a value.
+  Result(T value) : payload(std::move(value)), succeeded(true) {}  // NOLINT(google-explicit-constructor)
+
+  /// @brief Holds an error.
+  Result(Error error) : failure(error), succeeded(false) {}  // NOLINT(google-explicit-constructor)
+
+  Result(const Result& other) : succeeded(other.succeeded) {
+    if (succeeded) {
+      ::new(static_cast<void*>(&payload)) T(other.payload);
+    } else {
+      ::new(static_cast<void*>(&failure)) Error(other.failure);
+    }
+  }
+
+  Result(Result&& other) noexcept : succeeded(other.succeeded) {
+    if (succeeded) {
+      ::new(static_cast<void*>(&payload)) T(std::move(other.payload));
+    } else {
+      ::new(static_cast<void*>(&failure)) Error(other.failure);
+    }
+  }
+
+  // Copies first, so that a throwing copy leaves it untouched.
+  Result& operator=(const Result& other) {
+    if (this != &other) {
+      Result copy(other);
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+
+  Result& operator=(Result&& other) noexcept {
+    if (this != &other) {
+      destroy();
+      ::new(static_cast<void*>(this)) Result(std::move(other));
+    }
+    return *this;
+  }
+
+  ~Result() {
+    destroy();
+  }
+
+  /// @brief Checks whether it holds a value.
+  COMMON613_NODISCARD bool hasValue() const {
+    return succeeded;
+  }
+
+  /// @copydoc hasValue
+  explicit operator bool() const {
+    return succeeded;
+  }
+
+  /// @brief Returns the value, or throws with the formatted error if it holds none.
+  COMMON613_NODISCARD T& value() & {
+    COMMON613_REQUIRE(succeeded, "{}", failure.message());
+    return payload;
+  }
+
+  /// @overload
+  COMMON613_NODISCARD const T& value() const& {
+    COMMON613_REQUIRE(succeeded, "{}", failure.message());
+    return payload;
+  }
+
+  /// @overload
+  COMMON613_NODISCARD T&& value() && {
+    COMMON613_REQUIRE(succeeded, "{}", failure.message());
+    return std::move(payload);
+  }
+
+  /// @brief Returns the value without checking. It must hold one.
+  T& operator*() {
+    return payload;
+  }
+
+  /// @overload
+  const T& operator*() const {
+    return payload;
+  }
+
+  /// @brief Accesses the value without checking. It must hold one.
+  T* operator->() {
+    return &payload;
+  }
+
+  /// @overload
+  const T* operator->() const {
+    return &payload;
+  }
+
+  /// @brief Returns the error. It must hold no value.
+  COMMON613_NODISCARD const Error& error() const {
+    return failure;
+  }
+
+private:
+  void destroy() {
+    if (succeeded) {
+      payload.~T();
+    } else {
+      failure.~Error();
+    }
+  }
+
+  union {
+    T payload;
+    Error failure;
+  };
+  bool succeeded;
+};
+
+/// @brief A result of an operation without a value.
+template <>
+class Result<void> {
+  static_assert(std::is_trivially_copyable<Error>::value, "Error is copied as a union member.");
+
+public:
+  /// @brief Holds success. No @ref Error is constructed.
+  Result() : succeeded(true) {}
+
+  /// @brief Holds an error.
+  Result(Error error) : failure(error), succeeded(false) {}  // NOLINT(google-explicit-constructor)
+
+  /// @brief Checks whether it is a success.
+  COMMON613_NODISCARD bool hasValue() const {
+    return succeeded;
+  }
+
+  /// @copydoc hasValue
+  explicit operator bool() const {
+    return succeeded;
+  }
+
+  /// @brief Throws with the formatted error if it is a failure.
+  void value() const {
+    COMMON613_REQUIRE(succeeded, "{}", failure.message());
+  }
+
+  /// @brief Returns the error. It must be a failure.
+  COMMON613_NODISCARD const Error& error() const {
+    return failure;
+  }
+
+private:
+  // Error is trivially copyable and destructible, so only construction depends on the alternative.
+  union {
+    Error failure;
+  };
+  bool succeeded;
+};
+
+/// @cond
+namespace internal {
+
+// Copies filePath into error, cutting it to fit.
+inline void capturePath(Error& error, const char* filePath) {
+  std::size_t length = std::strlen(filePath);
+  if (length < Error::pathCapacity) {
+    std::memcpy(error.path, filePath, length + 1);
+    return;
+  }
+  constexpr std::size_t kept = Error::pathCapacity - 4;
+  std::memcpy(error.path, filePath, kept);
+  std::memcpy(error.path + kept, "...", 4);
+}
+
+inline Error makeError(Operation operation, int code, std::size_t done = 0, std::size_t required = 0) {
+  Error error;
+  error.operation = operation;
+  error.code = code;
+  error.done = done;
+  error.required = required;
+  return error;
+}
+
+// errno of a stream that failed a transfer, or 0 if it only hit the end of file.
+inline int streamErrno(const File& file) {
+  return std::ferror(file.get()) ? (errno == 0 ? EIO : errno) : 0;
+}
+
+}
+/// @endcond
+
+/// @brief Opens a file like @ref open, returning the error instead of throwing.
+COMMON613_NODISCARD inline Result<File> tryOpen(const char* filePath, const char* mode) {
+  errno = 0;
+  File file = open(filePath, mode, std::nothrow);
+  if (file == nullptr) {
+    Error error = internal::makeError(Operation::open, errno);
+    internal::capturePath(error, filePath);
+    return error;
+  }
+  return file;
+}
+
+/// @overload
+COMMON613_NODISCARD inline Result<File> tryOpen(const std::string& filePath, const char* mode) {
+  return tryOpen(filePath.c_str(), mode);
+}
+
+/// @overload
+COMMON613_NODISCARD inline Result<File> tryOpen(const filesystem::path& filePath, const char* mode) {
+  errno = 0;
+  File file = open(filePath, mode, std::nothrow);
+  if (file == nullptr) {
+    Error error = internal::makeError(Operation::open, errno);
+    COMMON613_CONSTEXPR_IF(std::is_same<filesystem::path::value_type, char>::value) {
+      internal::capturePath(error, reinterpret_cast<const char*>(filePath.c_str()));
+    }
+    return error;
+  }
+  return file;
+}
+
+/// @brief Reads @p count data units of type @p T like @ref read, returning the error instead of throwing.
+template <class T>
+COMMON613_NODISCARD Result<void> tryRead(const File& file, T* buffer, std::size_t count = 1) {
+  errno = 0;
+  std::size_t countRead = read(file, buffer, std::nothrow, count);
+  if (countRead != count) {
+    return internal::makeError(Operation::read, internal::streamErrno(file), countRead, count);
+  }
+  return {};
+}
+
+/// @brief Writes @p count data units of type @p T like @ref write, returning the error instead of throwing.
+template <class T>
+COMMON613_NODISCARD Result<void> tryWrite(const File& file, T* buffer, std::size_t count = 1) {
+  errno = 0;
+  std::size_t countWritten = write(file, buffer, std::nothrow, count);
+  if (countWritten != count) {
+    return internal::makeError(Operation::write, internal::streamErrno(file), countWritten, count);
+  }
+  return {};
+}
+
+/// @brief Calls @c fseek like @ref seek, returning the error instead of throwing.
+COMMON613_NODISCARD inline Result<void> trySeek(const File& file, long offset, int orig) {
+  if (std::fseek(file.get(), offset, orig) != 0) {
+    return internal::makeError(Operation::seek, errno);
+  }
+  return {};
+}
+
+/// @brief Reads all data from @p file like @ref readAll, returning the error instead of throwing.
+COMMON613_NODISCARD inline Result<Memory> tryReadAll(const File& file) {
+  FILE* pFile = file.get();
+  Result<void> sought = trySeek(file, 0, SEEK_END);
+  if (!sought) {
+    return sought.error();
+  }
+  long size = std::ftell(pFile);
+  if (size < 0) {
+    return internal::makeError(Operation::tell, errno);
+  }
+  sought = trySeek(file, 0, SEEK_SET);
+  if (!sought) {
+    return sought.error();
+  }
+  Memory buffer(static_cast<std::size_t>(size));
+  Result<void> loaded = tryRead(file, buffer.data(), buffer.size());
+  if (!loaded) {
+    return loaded.error();
+  }
+  return buffer;
+}
+
+}
+
+}
+
+#endif //COMMON613_FILE_RESULT_H
@@ -0,0 +1,284 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+/// @file
+/// @brief An open-addressing hash map with flat storage, mainly for @ref ArrNi keys.
+
+#pragma once
+#ifndef COMMON613_FLAT_HASH_MAP_H
+#define COMMON613_FLAT_HASH_MAP_H
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <common613/assert.h>
+#include <common613/compat/cpp17.h>
+#include <common613/vector_arith_utils.h>
+#include <common613/vector_hash.h>
+
+namespace common613 {
+
+/**
+ * @brief A hash map with linear probing in a power-of-two sized flat array.
+ *
+ * Lookups touch consecutive slots only, which suits small keys like @ref ArrNi.
+ * Deletion shifts following entries back, so no tombstones are left.
+ *
+ * @tparam Key Key type, default constructible.
+ * @tparam Value Mapped type, default constructible.
+ * @tparam Hash Hash function. Only low bits are used, so it should be well-mixed like @ref hashValue .
+ * @tparam KeyEqual Key comparator.
+ * @note Iterators and references are invalidated by insertion and deletion. Keys must not be modified via iterators.
+ */
+template <class Key, class Value, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+class FlatHashMap {
+  static_assert(std::is_default_constructible<Key>::value && std::is_default_constructible<Value>::value,
+                "FlatHashMap requires default constructible keys and values.");
+
+public:
+  /// @brief Key type.
+  using keyType = Key;
+  /// @brief Mapped type.
+  using mappedType = Value;
+  /// @brief Element type.
+  using valueType = std::pair<Key, Value>;
+
+  /// @brief Forward iterator over occupied slots.
+  template <bool Const>
+  class Iterator {
+    using Map = std::conditional_t<Const, const FlatHashMap, FlatHashMap>;
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = valueType;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const valueType*, valueType*>;
+    using reference = std::conditional_t<Const, const valueType&, valueType&>;
+
+    Iterator() = default;
+    Iterator(Map* map, std::size_t index) : map(map), index(index) { skip(); }
+    /// @brief Converts a mutable iterator into a const one.
+    template <bool OtherConst, class Enabled = std::enable_if_t<Const && !OtherConst>>
+    Iterator(const Iterator<OtherConst>& other) : map(other.map), index(other.index) {}
+
+    reference operator*() const { return map->slots[index]; }
+    pointer operator->() const { return &map->slots[index]; }
+
+    Iterator& operator++() {
+      ++index;
+      skip();
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator ret = *this;
+      ++*this;
+      return ret;
+    }
+
+    friend bool operator==(const Iterator& lhs, const Iterator& rhs) { return lhs.index == rhs.index; }
+    friend bool operator!=(const Iterator& lhs, const Iterator& rhs) { return lhs.index != rhs.index; }
+
+  private:
+    friend class FlatHashMap;
+    template <bool> friend class Iterator;
+
+    void skip() {
+      while (index < map->slots.size() && !map->occupied[index]) {
+        ++index;
+      }
+    }
+
+    Map* map = nullptr;
+    std::size_t index = 0;
+  };
+
+  /// @brief Mutable iterator.
+  using iterator = Iterator<false>;
+  /// @brief Const iterator.
+  using const_iterator = Iterator<true>;
+
+  FlatHashMap() = default;
+
+  /// @brief Constructs a map able to hold @p count elements without rehashing.
+  explicit FlatHashMap(std::size_t count, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+      : hasher(hash), equal(equal) {
+    reserve(count);
+  }
+
+  COMMON613_NODISCARD iterator begin() { return iterator(this, 0); }
+  COMMON613_NODISCARD iterator end() { return iterator(this, slots.size()); }
+  COMMON613_NODISCARD const_iterator begin() const { return const_iterator(this, 0); }
+  COMMON613_NODISCARD const_iterator end() const { return const_iterator(this, slots.size()); }
+
+  /// @brief Returns the count of elements.
+  COMMON613_NODISCARD std::size_t size() const { return elementCount; }
+  /// @brief Returns if there is no element.
+  COMMON613_NODISCARD bool empty() const { return elementCount == 0; }
+  /// @brief Returns the count of slots.
+  COMMON613_NODISCARD std::size_t capacity() const { return slots.size(); }
+
+  /// @brief Removes all elements but keeps the slots.
+  void clear() {
+    for (std::size_t i = 0; i < slots.size(); ++i) {
+      if (occupied[i]) {
+        slots[i] = valueType();
+        occupied[i] = false;
+      }
+    }
+    elementCount = 0;
+  }
+
+  /// @brief Makes room for @p newCount elements without exceeding the maximum load factor.
+  void reserve(std::size_t newCount) {
+    std::size_t newCapacity = slots.empty() ? minCapacity : slots.size();
+    while (newCount > maxLoad(newCapacity)) {
+      newCapacity *= 2;
+    }
+    if (newCapacity != slots.size()) {
+      rehash(newCapacity);
+    }
+  }
+
+  /// @brief Finds the element with @p key , or returns @ref end().
+  COMMON613_NODISCARD iterator find(const Key& key) { return iterator(this, findIndex(key)); }
+  /// @overload
+  COMMON613_NODISCARD const_iterator find(const Key& key) const { return const_iterator(this, findIndex(key)); }
+
+  /// @brief Returns if an element with @p key exists.
+  COMMON613_NODISCARD bool contains(const Key& key) const { return findIndex(key) != slots.size(); }
+  /// @brief Returns the count of elements with @p key , either 0 or 1.
+  COMMON613_NODISCARD std::size_t count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+  /// @brief Inserts a value constructed from @p args if @p key does not exist.
+  /// @return The iterator to the element with @p key, and whether insertion took place.
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+    std::size_t index = findIndex(key);
+    if (index != slots.size()) {
+      return {iterator(this, index), false};
+    }
+    // Grows only for a real insertion, so hits keep iterators valid.
+    reserve(elementCount + 1);
+    index = slotOf(key);
+    while (occupied[index]) {
+      index = (index + 1) & (slots.size() - 1);
+    }
+    slots[index] = valueType(std::piecewise_construct, std::forward_as_tuple(key),
+                             std::forward_as_tuple(std::forward<Args>(args)...));
+    occupied[index] = true;
+    ++elementCount;
+    return {iterator(this, index), true};
+  }
+
+  /// @brief Inserts @p value if its key does not exist.
+  std::pair<iterator, bool> insert(const valueType& value) { return try_emplace(value.first, value.second); }
+  /// @overload
+  std::pair<iterator, bool> insert(valueType&& value) { return try_emplace(value.first, std::move(value.second)); }
+
+  /// @brief Returns the value with @p key , inserting a default one if it does not exist.
+  Value& operator[](const Key& key) { return try_emplace(key).first->second; }
+
+  /// @brief Returns the value with @p key , which is required to exist.
+  Value& at(const Key& key) {
+    std::size_t index = findIndex(key);
+    COMMON613_REQUIRE(index != slots.size(), "Key not found in FlatHashMap.");
+    return slots[index].second;
+  }
+
+  /// @overload
+  const Value& at(const Key& key) const {
+    std::size_t index = findIndex(key);
+    COMMON613_REQUIRE(index != slots.size(), "Key not found in FlatHashMap.");
+    return slots[index].second;
+  }
+
+  /// @brief Removes the element with @p key .
+  /// @return The count of elements removed, either 0 or 1.
+  std::size_t erase(const Key& key) {
+    std::size_t index = findIndex(key);
+    if (index == slots.size()) {
+      return 0;
+    }
+    eraseAt(index);
+    return 1;
+  }
+
+  /// @brief Removes the element at @p pos .
+  void erase(const_iterator pos) {
+    eraseAt(pos.index);
+  }
+
+private:
+  constexpr static const std::size_t minCapacity = 8;
+
+  // Keeps the load factor at most 3/4, where linear probing still has short probe sequences.
+  constexpr static std::size_t maxLoad(std::size_t capacity) {
+    return capacity / 4 * 3;
+  }
+
+  std::size_t slotOf(const Key& key) const {
+    return hasher(key) & (slots.size() - 1);
+  }
+
+  std::size_t findIndex(const Key& key) const {
+    if (elementCount == 0) {
+      return slots.size();
+    }
+    std::size_t index = slotOf(key);
+    while (occupied[index]) {
+      if (equal(slots[index].first, key)) {
+        return index;
+      }
+      index = (index + 1) & (slots.size() - 1);
+    }
+    return slots.size();
+  }
+
+  void eraseAt(std::size_t hole) {
+    const std::size_t mask = slots.size() - 1;
+    for (std::size_t next = (hole + 1) & mask; occupied[next]; next = (next + 1) & mask) {
+      // Moves back an element unless its home slot lies cyclically in (hole, next].
+      std::size_t home = slotOf(slots[next].first);
+      if (((next - home) & mask) >= ((next - hole) & mask)) {
+        slots[hole] = std::move(slots[next]);
+        hole = next;
+      }
+    }
+    slots[hole] = valueType();
+    occupied[hole] = false;
+    --elementCount;
+  }
+
+  void rehash(std::size_t newCapacity) {
+    std::vector<valueType> oldSlots(newCapacity);
+    std::vector<unsigned char> oldOccupied(newCapacity, false);
+    oldSlots.swap(slots);
+    oldOccupied.swap(occupied);
+    const std::size_t mask = newCapacity - 1;
+    for (std::size_t i = 0; i < oldSlots.size(); ++i) {
+      if (oldOccupied[i]) {
+        std::size_t index = slotOf(oldSlots[i].first);
+        while (occupied[index]) {
+          index = (index + 1) & mask;
+        }
+        slots[index] = std::move(oldSlots[i]);
+        occupied[index] = true;
+      }
+    }
+  }
+
+  std::vector<valueType> slots;
+  std::vector<unsigned char> occupied;
+  std::size_t elementCount = 0;
+  Hash hasher;
+  KeyEqual equal;
+};
+
+}
+
+#endif //COMMON613_FLAT_HASH_MAP_H
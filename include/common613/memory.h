@@ -2,12 +2,16 @@
 // Copyright (c) 2021 613_forever
 
 /// @file
-/// @brief Defines typedef @ref Memory .
+/// @brief Defines typedefs @ref Memory and @ref UninitializedMemory .
 
 #pragma once
 #ifndef COMMON613_COMMON_H
 #define COMMON613_COMMON_H
 
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace common613 {
@@ -15,6 +19,41 @@ namespace common613 {
 /// @brief Type for unaligned raw memory.
 using Memory = std::vector<unsigned char>;
 
+/**
+ * @brief Allocator leaving elements default-initialized rather than value-initialized.
+ *
+ * @c resize with it does not zero-fill trivial elements, for buffers about to be overwritten entirely.
+ */
+template <class T, class Base = std::allocator<T>>
+class DefaultInitAllocator : public Base {
+  using Traits = std::allocator_traits<Base>;
+
+ public:
+  template <class U>
+  struct rebind {
+    using other = DefaultInitAllocator<U, typename Traits::template rebind_alloc<U>>;
+  };
+
+  DefaultInitAllocator() = default;
+
+  template <class U, class OtherBase>
+  DefaultInitAllocator(const DefaultInitAllocator<U, OtherBase>& other) noexcept  // NOLINT(google-explicit-constructor)
+      : Base(static_cast<const OtherBase&>(other)) {}
+
+  template <class U>
+  void construct(U* ptr) noexcept(std::is_nothrow_default_constructible<U>::value) {
+    ::new(static_cast<void*>(ptr)) U;
+  }
+
+  template <class U, class... Args>
+  void construct(U* ptr, Args&& ... args) {
+    Traits::construct(static_cast<Base&>(*this), ptr, std::forward<Args>(args)...);
+  }
+};
+
+/// @brief Type for unaligned raw memory, whose @c resize leaves new bytes uninitialized.
+using UninitializedMemory = std::vector<unsigned char, DefaultInitAllocator<unsigned char>>;
+
 }
 
 #endif //COMMON613_COMMON_H
@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+/// @file
+/// @brief Splits text read from a @ref File into delimited records without copying.
+
+#pragma once
+#ifndef COMMON613_RECORD_READER_H
+#define COMMON613_RECORD_READER_H
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <common613/assert.h>
+#include <common613/file_utils.h>
+#include <common613/compat/cpp17.h>
+#include <common613/compat/simd.h>
+#include <common613/compat/string_view.h>
+
+namespace common613 {
+
+/// @cond
+namespace internal {
+
+// Returns the first position of byte in [first, last), or last if not found.
+inline const char* findByte(const char* first, const char* last, char byte) {
+#ifdef COMMON613_HAS_AVX2
+  const __m256i needle32 = _mm256_set1_epi8(byte);
+  for (; last - first >= 32; first += 32) {
+    __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+    auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle32)));
+    if (mask != 0) {
+      return first + countTrailingZeros(mask);
+    }
+  }
+#endif
+#ifdef COMMON613_HAS_SSE2
+  const __m128i needle16 = _mm_set1_epi8(byte);
+  for (; last - first >= 16; first += 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+    auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle16)));
+    if (mask != 0) {
+      return first + countTrailingZeros(mask);
+    }
+  }
+#endif
+  for (; first != last; ++first) {
+    if (*first == byte) {
+      return first;
+    }
+  }
+  return last;
+}
+
+}
+/// @endcond
+
+namespace file {
+
+/**
+ * @brief Reads delimiter-separated records, e.g. lines, from a @ref File.
+ *
+ * Data are read in large blocks and scanned with SSE2/AVX2 when available.
+ * Records are returned as views into an internal buffer, so they are valid only until the next call to @ref next.
+ * A record straddling two blocks is moved to the front of the buffer, which grows if a record outsizes it.
+ */
+class RecordReader {
+public:
+  /// @brief Default size of blocks to read.
+  constexpr static const std::size_t defaultBufferSize = 1 << 20;
+
+  /// @brief Reads from the current position of @p file , which must outlive the reader.
+  explicit RecordReader(const File& file, char delimiter = '\n', std::size_t bufferSize = defaultBufferSize)
+      : file(file), delimiter(delimiter), buffer(bufferSize == 0 ? 1 : bufferSize) {}
+
+  /**
+   * @brief Fetches the next record, excluding its delimiter.
+   * @return @c false if all records are consumed.
+   * @note The last record is returned even if it does not end with a delimiter.
+   */
+  bool next(string_view& record) {
+    while (true) {
+      const char* data = buffer.data();
+      const char* found = internal::findByte(data + scanned, data + end, delimiter);
+      if (found != data + end) {
+        std::size_t position = found - data;
+        record = string_view(data + begin, position - begin);
+        begin = scanned = position + 1;
+        return true;
+      }
+      scanned = end;
+      if (eof) {
+        if (begin == end) {
+          return false;
+        }
+        record = string_view(data + begin, end - begin);
+        begin = scanned = end;
+        return true;
+      }
+      refill();
+    }
+  }
+
+private:
+  void refill() {
+    if (begin != 0) {
+      std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+      end -= begin;
+      scanned -= begin;
+      begin = 0;
+    }
+    if (end == buffer.size()) {
+      buffer.resize(buffer.size() * 2);
+    }
+    std::size_t countRead = std::fread(buffer.data() + end, 1, buffer.size() - end, file.get());
+    if (countRead == 0) {
+      COMMON613_REQUIRE(!std::ferror(file.get()), "Failed to read records. Error code: {}.", std::ferror(file.get()));
+      eof = true;
+    }
+    end += countRead;
+  }
+
+  const File& file;
+  char delimiter;
+  std::vector<char> buffer;
+  // Unconsumed data are in [begin, end), and [begin, scanned) contains no delimiter.
+  std::size_t begin = 0;
+  std::size_t scanned = 0;
+  std::size_t end = 0;
+  bool eof = false;
+};
+
+}
+
+}
+
+#endif //COMMON613_RECORD_READER_H
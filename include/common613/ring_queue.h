@@ -0,0 +1,214 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+/// @file
+/// @brief Bounded lock-free ring queues, for single or multiple producers and consumers.
+
+#pragma once
+#ifndef COMMON613_RING_QUEUE_H
+#define COMMON613_RING_QUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <common613/compat/cpp17.h>
+#include <common613/compat/simd.h>
+#include <common613/thread_pool.h>
+
+namespace common613 {
+
+/// @cond
+namespace internal {
+
+inline std::size_t ringCapacity(std::size_t capacity) {
+  std::size_t ret = 2;
+  while (ret < capacity) {
+    ret *= 2;
+  }
+  return ret;
+}
+
+// Waits between failed attempts, spinning with CPU pause hints in doubling rounds, then yielding, then sleeping.
+class Backoff {
+public:
+  void pause() {
+    if (count < spinRounds) {
+      for (unsigned i = 0; i < (1u << count); ++i) {
+        relax();
+      }
+      ++count;
+    } else if (count < spinRounds + yieldRounds) {
+      ++count;
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+
+  void reset() {
+    count = 0;
+  }
+
+private:
+  constexpr static const unsigned spinRounds = 8;
+  constexpr static const unsigned yieldRounds = 64;
+
+  static void relax() {
+#ifdef COMMON613_HAS_SSE2
+    _mm_pause();
+#elif defined(__aarch64__) && defined(__GNUC__)
+    __asm__ __volatile__("yield");
+#endif
+  }
+
+  unsigned count = 0;
+};
+
+}
+/// @endcond
+
+/**
+ * @brief A bounded lock-free queue for exactly one producer thread and one consumer thread.
+ *
+ * Capacity is rounded up to a power of 2. Elements stay in their slots after being popped until overwritten.
+ */
+template <class T>
+class SpscQueue {
+public:
+  /// @brief Creates a queue holding at least @p capacity elements.
+  explicit SpscQueue(std::size_t capacity) : slots(internal::ringCapacity(capacity)), mask(slots.size() - 1) {}
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  /// @brief Returns the count of elements it can hold.
+  COMMON613_NODISCARD std::size_t capacity() const { return slots.size(); }
+
+  /// @brief Appends @p value , from the producer thread.
+  /// @return @c false if the queue is full, when @p value is left untouched.
+  COMMON613_NODISCARD bool tryPush(T&& value) {
+    const std::size_t t = tail.load(std::memory_order_relaxed);
+    if (t - cachedHead == slots.size()) {
+      cachedHead = head.load(std::memory_order_acquire);
+      if (t - cachedHead == slots.size()) {
+        return false;
+      }
+    }
+    slots[t & mask] = std::move(value);
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// @brief Takes the first element into @p value , from the consumer thread.
+  /// @return @c false if the queue is empty.
+  COMMON613_NODISCARD bool tryPop(T& value) {
+    const std::size_t h = head.load(std::memory_order_relaxed);
+    if (h == cachedTail) {
+      cachedTail = tail.load(std::memory_order_acquire);
+      if (h == cachedTail) {
+        return false;
+      }
+    }
+    value = std::move(slots[h & mask]);
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  std::vector<T> slots;
+  std::size_t mask;
+  // Consumer side.
+  alignas(internal::cacheLineSize) std::atomic<std::size_t> head{0};
+  std::size_t cachedTail = 0;
+  // Producer side.
+  alignas(internal::cacheLineSize) std::atomic<std::size_t> tail{0};
+  std::size_t cachedHead = 0;
+};
+
+/**
+ * @brief A bounded lock-free queue for any count of producer and consumer threads.
+ *
+ * Each slot carries a sequence number telling whose turn it is, so that producers and consumers
+ * only contend on their own positions with one compare-and-swap per operation.
+ * Capacity is rounded up to a power of 2.
+ */
+template <class T>
+class MpmcQueue {
+public:
+  /// @brief Creates a queue holding at least @p capacity elements.
+  explicit MpmcQueue(std::size_t capacity)
+      : mask(internal::ringCapacity(capacity) - 1), cells(new Cell[mask + 1]) {
+    for (std::size_t i = 0; i <= mask; ++i) {
+      cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpmcQueue(const MpmcQueue&) = delete;
+  MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+  /// @brief Returns the count of elements it can hold.
+  COMMON613_NODISCARD std::size_t capacity() const { return mask + 1; }
+
+  /// @brief Appends @p value .
+  /// @return @c false if the queue is full, when @p value is left untouched.
+  COMMON613_NODISCARD bool tryPush(T&& value) {
+    std::size_t position = enqueuePosition.load(std::memory_order_relaxed);
+    while (true) {
+      Cell& cell = cells[position & mask];
+      std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<std::ptrdiff_t>(sequence - position);
+      if (diff == 0) {
+        if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+          cell.value = std::move(value);
+          cell.sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        position = enqueuePosition.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// @brief Takes the first element into @p value .
+  /// @return @c false if the queue is empty.
+  COMMON613_NODISCARD bool tryPop(T& value) {
+    std::size_t position = dequeuePosition.load(std::memory_order_relaxed);
+    while (true) {
+      Cell& cell = cells[position & mask];
+      std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+      if (diff == 0) {
+        if (dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+          value = std::move(cell.value);
+          cell.sequence.store(position + mask + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        position = dequeuePosition.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+private:
+  struct Cell {
+    std::atomic<std::size_t> sequence;
+    T value;
+  };
+
+  std::size_t mask;
+  std::unique_ptr<Cell[]> cells;
+  alignas(internal::cacheLineSize) std::atomic<std::size_t> enqueuePosition{0};
+  alignas(internal::cacheLineSize) std::atomic<std::size_t> dequeuePosition{0};
+};
+
+}
+
+#endif //COMMON613_RING_QUEUE_H
@@ -0,0 +1,234 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+/// @file
+/// @brief Cheap raw stack capture, with symbolization deferred to a background thread or done offline.
+
+#pragma once
+#ifndef COMMON613_STACKTRACE_H
+#define COMMON613_STACKTRACE_H
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <fmt/format.h>
+#include <boost/stacktrace.hpp>
+#include <common613/assert.h>
+#include <common613/compat/cpp17.h>
+
+namespace common613 {
+
+/**
+ * @brief Instruction addresses of a call stack, captured into a fixed buffer without allocation or symbolization.
+ *
+ * Capturing walks the stack with the unwinder and costs microseconds.
+ * Addresses are resolved into names only by @ref symbolize, or offline from @ref dumpAddresses and @ref moduleMap.
+ */
+class RawStackTrace {
+public:
+  /// @brief Maximum count of frames kept.
+  constexpr static const std::size_t maxDepth = 64;
+
+  /// @brief Captures the stack of the calling thread, skipping its @p skip innermost frames.
+  COMMON613_NODISCARD static RawStackTrace capture(std::size_t skip = 0) noexcept {
+    RawStackTrace ret;
+    // Skips this function itself too.
+    std::size_t depth = boost::stacktrace::safe_dump_to(skip + 1, ret.frames.data(), sizeof(ret.frames));
+    while (depth != 0 && ret.frames[depth - 1] == nullptr) {
+      --depth;
+    }
+    ret.depth = depth;
+    return ret;
+  }
+
+  /// @brief Count of captured frames.
+  COMMON613_NODISCARD std::size_t size() const {
+    return depth;
+  }
+
+  /// @brief Checks whether no frame is captured.
+  COMMON613_NODISCARD bool empty() const {
+    return depth == 0;
+  }
+
+  /// @brief Returns the address of frame @p i , the innermost first.
+  const void* operator[](std::size_t i) const {
+    return frames[i];
+  }
+
+  /// @brief Resolves the frames into text like @c boost::stacktrace, which may take milliseconds.
+  COMMON613_NODISCARD std::string symbolize() const {
+    return boost::stacktrace::to_string(
+        boost::stacktrace::stacktrace::from_dump(frames.data(), depth * sizeof(frames[0])));
+  }
+
+  /// @brief Formats the addresses one per line in hex, to be resolved offline with @ref moduleMap.
+  COMMON613_NODISCARD std::string dumpAddresses() const {
+    std::string ret;
+    for (std::size_t i = 0; i < depth; ++i) {
+      ret += fmt::format("{:2}# {}\n", i, frames[i]);
+    }
+    return ret;
+  }
+
+private:
+  std::array<void*, maxDepth> frames{};
+  std::size_t depth = 0;
+};
+
+/**
+ * @brief Returns the executable mappings of the process, to map dumped addresses to modules and offsets offline.
+ * @note Lines are in the format of @c /proc/self/maps. It is empty where that is unavailable.
+ */
+COMMON613_NODISCARD inline std::string moduleMap() {
+  std::string ret;
+#ifdef __linux__
+  std::ifstream maps("/proc/self/maps");
+  std::string line;
+  while (std::getline(maps, line)) {
+    std::size_t perms = line.find(' ');
+    if (perms != std::string::npos && perms + 3 < line.size() && line[perms + 3] == 'x') {
+      ret += line;
+      ret += '\n';
+    }
+  }
+#endif
+  return ret;
+}
+
+/**
+ * @brief Formats posted @ref RawStackTrace "RawStackTraces" on a background thread and hands the text to a sink.
+ *
+ * Posting only copies the addresses into a ring of slots allocated up front, so it never allocates,
+ * and traces are dropped and counted rather than blocking when the ring is full.
+ */
+class TraceSymbolizer {
+public:
+  /// @brief Receives formatted traces on the background thread.
+  using Sink = std::function<void(const std::string&)>;
+
+  /// @brief Default count of slots for traces waiting to be handled.
+  constexpr static const std::size_t defaultCapacity = 1024;
+
+  /**
+   * @brief Starts the background thread.
+   * @param symbolize Whether to resolve names. If not, addresses are passed on as @ref RawStackTrace::dumpAddresses,
+   * preceded by @ref moduleMap once, for symbolization offline.
+   */
+  explicit TraceSymbolizer(Sink sink, bool symbolize = true, std::size_t capacity = defaultCapacity)
+      : sink(std::move(sink)), symbolize(symbolize), slots(std::max<std::size_t>(capacity, 1)),
+        worker([this] { run(); }) {}
+
+  TraceSymbolizer(const TraceSymbolizer&) = delete;
+  TraceSymbolizer& operator=(const TraceSymbolizer&) = delete;
+
+  /// @brief Handles traces left in the queue, then stops the background thread.
+  ~TraceSymbolizer() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wakeWorker.notify_one();
+    worker.join();
+  }
+
+  /// @brief Queues @p trace for the background thread.
+  /// @return @c false if the queue is full and @p trace is dropped.
+  bool post(const RawStackTrace& trace) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (count == slots.size()) {
+        ++droppedCount;
+        return false;
+      }
+      slots[(head + count) % slots.size()] = trace;
+      ++count;
+    }
+    wakeWorker.notify_one();
+    return true;
+  }
+
+  /// @brief Waits until all traces posted so far are handed to the sink.
+  void flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return count == 0 && !busy; });
+  }
+
+  /// @brief Count of traces dropped because all slots were taken.
+  COMMON613_NODISCARD std::size_t dropped() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return droppedCount;
+  }
+
+  /**
+   * @brief The instance used by @ref COMMON613_TRACE, logging with @ref COMMON613_LOG_DEBUG.
+   *
+   * Names are resolved unless @c COMMON613_STACKTRACE_RAW is defined to @c 1.
+   */
+  static TraceSymbolizer& instance() {
+#if defined(COMMON613_STACKTRACE_RAW) && COMMON613_STACKTRACE_RAW == 1
+    constexpr bool symbolize = false;
+#else
+    constexpr bool symbolize = true;
+#endif
+    static TraceSymbolizer symbolizer([](const std::string& text) { COMMON613_LOG_DEBUG(text); }, symbolize);
+    return symbolizer;
+  }
+
+private:
+  void run() {
+    bool modulesSent = false;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      wakeWorker.wait(lock, [this] { return stopping || count != 0; });
+      if (count == 0) {
+        return;
+      }
+      RawStackTrace trace = slots[head];
+      head = (head + 1) % slots.size();
+      --count;
+      busy = true;
+      lock.unlock();
+      if (symbolize) {
+        sink(trace.symbolize());
+      } else {
+        if (!modulesSent) {
+          sink(moduleMap());
+          modulesSent = true;
+        }
+        sink(trace.dumpAddresses());
+      }
+      lock.lock();
+      busy = false;
+      if (count == 0) {
+        idle.notify_all();
+      }
+    }
+  }
+
+  Sink sink;
+  bool symbolize;
+  mutable std::mutex mutex;
+  std::condition_variable wakeWorker;
+  std::condition_variable idle;
+  // Queued traces are slots[head], ..., slots[(head + count - 1) % slots.size()].
+  std::vector<RawStackTrace> slots;
+  std::size_t head = 0;
+  std::size_t count = 0;
+  std::size_t droppedCount = 0;
+  bool busy = false;
+  bool stopping = false;
+  std::thread worker;
+};
+
+}
+
+#endif //COMMON613_STACKTRACE_H
@@ -0,0 +1,363 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+/// @file
+/// @brief A work-stealing thread pool and parallel algorithms over contiguous arrays, e.g. of @ref ArrNi.
+
+#pragma once
+#ifndef COMMON613_THREAD_POOL_H
+#define COMMON613_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <common613/compat/cpp17.h>
+
+namespace common613 {
+
+/**
+ * @brief A fixed-size thread pool where each worker owns a task queue and steals from the others when idle.
+ *
+ * Workers pop their own queues in LIFO order for locality, and steal in FIFO order to take the oldest,
+ * usually largest, pieces of work. Threads waiting in parallel algorithms run queued tasks while there are any,
+ * so nested parallel calls keep making progress; once nothing is left to help with, they block until their own
+ * tasks, possibly running on other threads, finish.
+ */
+class ThreadPool {
+public:
+  /// @brief Starts @p threadCount workers. With 0 workers, all tasks run on the calling thread.
+  explicit ThreadPool(std::size_t threadCount = defaultThreadCount()) : queues(threadCount) {
+    for (auto& queue : queues) {
+      queue = std::make_unique<Queue>();
+    }
+    workers.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i) {
+      workers.emplace_back([this, i] { workerLoop(i); });
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /// @brief Finishes all queued tasks and joins the workers.
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(sleepMutex);
+      stopping = true;
+    }
+    sleepCondition.notify_all();
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
+
+  /// @brief Returns a process-wide pool with one worker per hardware thread.
+  COMMON613_NODISCARD static ThreadPool& instance() {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  /// @brief Returns the count of hardware threads, at least 1.
+  COMMON613_NODISCARD static std::size_t defaultThreadCount() {
+    return std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  /// @brief Returns the count of workers.
+  COMMON613_NODISCARD std::size_t size() const { return workers.size(); }
+
+  /// @brief Queues @p task, which must not throw.
+  /// @note Tasks submitted from a worker go to its own queue.
+  void submit(std::function<void()> task) {
+    if (queues.empty()) {
+      task();
+      return;
+    }
+    std::size_t index = currentPool() == this ? currentIndex() : nextQueue++ % queues.size();
+    {
+      std::lock_guard<std::mutex> lock(queues[index]->mutex);
+      queues[index]->tasks.push_back(std::move(task));
+    }
+    pending.fetch_add(1, std::memory_order_release);
+    {
+      std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    sleepCondition.notify_one();
+  }
+
+  /// @brief Runs one queued task on the calling thread if there is any.
+  /// @return Whether a task is run.
+  bool tryRunOne() {
+    bool isWorker = currentPool() == this;
+    std::size_t self = isWorker ? currentIndex() : 0;
+    std::function<void()> task;
+    if (isWorker && pop(self, task, false)) {
+      task();
+      return true;
+    }
+    for (std::size_t i = isWorker ? 1 : 0; i < queues.size(); ++i) {
+      if (pop((self + i) % queues.size(), task, true)) {
+        task();
+        return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  static const ThreadPool*& currentPool() {
+    thread_local const ThreadPool* pool = nullptr;
+    return pool;
+  }
+
+  static std::size_t& currentIndex() {
+    thread_local std::size_t index = 0;
+    return index;
+  }
+
+  bool pop(std::size_t index, std::function<void()>& task, bool steal) {
+    Queue& queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+      return false;
+    }
+    if (steal) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+    } else {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+    }
+    pending.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  void workerLoop(std::size_t index) {
+    currentPool() = this;
+    currentIndex() = index;
+    while (true) {
+      if (tryRunOne()) {
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(sleepMutex);
+      sleepCondition.wait(lock, [this] { return stopping || pending.load(std::memory_order_acquire) != 0; });
+      if (stopping && pending.load(std::memory_order_acquire) == 0) {
+        return;
+      }
+    }
+  }
+
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<std::thread> workers;
+  std::atomic<std::size_t> pending{0};
+  std::atomic<std::size_t> nextQueue{0};
+  std::mutex sleepMutex;
+  std::condition_variable sleepCondition;
+  bool stopping = false;
+};
+
+/// @brief Default count of elements per task in parallel algorithms.
+constexpr const std::size_t defaultGrainSize = 4096;
+
+/// @cond
+namespace internal {
+
+constexpr const std::size_t cacheLineSize = 64;
+
+// Count of elements in a cache line, or 1 if elements do not tile cache lines.
+template <class T>
+constexpr std::size_t elementsPerCacheLine() {
+  return sizeof(T) < cacheLineSize && cacheLineSize % sizeof(T) == 0 ? cacheLineSize / sizeof(T) : 1;
+}
+
+// Count of elements before the first cache line boundary after p.
+template <class T>
+inline std::size_t elementsToCacheLine(const T* p) {
+  std::size_t misalignment = reinterpret_cast<std::uintptr_t>(p) % cacheLineSize;
+  if (elementsPerCacheLine<T>() == 1 || misalignment % sizeof(T) != 0) {
+    return 0;
+  }
+  return (cacheLineSize - misalignment) % cacheLineSize / sizeof(T);
+}
+
+// Holds a partial result of a chunk. Wrapping keeps std::vector<bool> packing, and so races, out of partials.
+template <class R>
+struct ReduceSlot {
+  R value;
+};
+
+struct ParallelJob {
+  std::atomic<std::size_t> remaining;
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool done = false;
+  std::exception_ptr exception;
+
+  void fail() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!exception) {
+      exception = std::current_exception();
+    }
+  }
+
+  void finishOne() {
+    if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      std::lock_guard<std::mutex> lock(mutex);
+      done = true;
+      condition.notify_all();
+    }
+  }
+};
+
+// Splits [0, count) into chunks whose boundaries are head + k * grain, and calls chunkFunc(chunkIndex, begin, end)
+// on each. The partition depends only on the arguments, never on the count of threads.
+template <class ChunkFunc>
+void runChunks(ThreadPool& pool, std::size_t count, std::size_t grain, std::size_t head, ChunkFunc&& chunkFunc) {
+  if (count == 0) {
+    return;
+  }
+  grain = std::max<std::size_t>(grain, 1);
+  head %= grain;
+  const std::size_t firstEnd = std::min(count, head + grain);
+  const std::size_t chunkCount = 1 + (count - firstEnd + grain - 1) / grain;
+  auto chunkBegin = [head, grain](std::size_t chunk) { return chunk == 0 ? 0 : head + chunk * grain; };
+  auto chunkEnd = [head, grain, count](std::size_t chunk) { return std::min(count, head + (chunk + 1) * grain); };
+
+  if (chunkCount == 1 || pool.size() == 0) {
+    for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+      chunkFunc(chunk, chunkBegin(chunk), chunkEnd(chunk));
+    }
+    return;
+  }
+
+  ParallelJob job;
+  job.remaining.store(chunkCount, std::memory_order_relaxed);
+  auto runChunk = [&](std::size_t chunk) {
+    try {
+      chunkFunc(chunk, chunkBegin(chunk), chunkEnd(chunk));
+    } catch (...) {
+      job.fail();
+    }
+    job.finishOne();
+  };
+  for (std::size_t chunk = 1; chunk < chunkCount; ++chunk) {
+    pool.submit([&runChunk, chunk] { runChunk(chunk); });
+  }
+  runChunk(0);
+  while (job.remaining.load(std::memory_order_acquire) != 0 && pool.tryRunOne()) {}
+  {
+    std::unique_lock<std::mutex> lock(job.mutex);
+    job.condition.wait(lock, [&job] { return job.done; });
+  }
+  if (job.exception) {
+    std::rethrow_exception(job.exception);
+  }
+}
+
+}
+/// @endcond
+
+/**
+ * @brief Calls @p f(i) for each @p i in [ @p begin, @p end ) in parallel, @p grain indices per task.
+ * @note The first exception thrown by @p f is rethrown after all tasks finish.
+ */
+template <class Func>
+void parallelFor(ThreadPool& pool, std::size_t begin, std::size_t end, Func&& f,
+                 std::size_t grain = defaultGrainSize) {
+  if (end <= begin) {
+    return;
+  }
+  internal::runChunks(pool, end - begin, grain, 0, [begin, &f](std::size_t, std::size_t first, std::size_t last) {
+    for (std::size_t i = begin + first; i < begin + last; ++i) {
+      f(i);
+    }
+  });
+}
+
+/// @overload
+template <class Func>
+void parallelFor(std::size_t begin, std::size_t end, Func&& f, std::size_t grain = defaultGrainSize) {
+  parallelFor(ThreadPool::instance(), begin, end, std::forward<Func>(f), grain);
+}
+
+/**
+ * @brief Writes @p f(input[i]) into @p output[i] for each @p i in [0, @p count ) in parallel.
+ *
+ * Task boundaries fall on cache line boundaries of @p output whenever possible,
+ * so that no two tasks write the same cache line. @p grain is rounded up to whole cache lines.
+ */
+template <class In, class Out, class Func>
+void parallelTransform(ThreadPool& pool, const In* input, std::size_t count, Out* output, Func&& f,
+                       std::size_t grain = defaultGrainSize) {
+  const std::size_t perLine = internal::elementsPerCacheLine<Out>();
+  grain = (std::max<std::size_t>(grain, 1) + perLine - 1) / perLine * perLine;
+  internal::runChunks(pool, count, grain, internal::elementsToCacheLine(output),
+                      [input, output, &f](std::size_t, std::size_t first, std::size_t last) {
+                        for (std::size_t i = first; i < last; ++i) {
+                          output[i] = f(input[i]);
+                        }
+                      });
+}
+
+/// @overload
+template <class In, class Out, class Func>
+void parallelTransform(const In* input, std::size_t count, Out* output, Func&& f,
+                       std::size_t grain = defaultGrainSize) {
+  parallelTransform(ThreadPool::instance(), input, count, output, std::forward<Func>(f), grain);
+}
+
+/**
+ * @brief Folds @p count items from @p input with @p op in parallel.
+ *
+ * Items are split into consecutive chunks of @p grain items regardless of the count of threads.
+ * Each chunk is folded from @p identity in order, and partial results are then folded in chunk order,
+ * so the result is reproducible for a fixed @p grain.
+ *
+ * @param identity The neutral element of @p op, e.g. zero vector for @c std::plus<>.
+ * @param op Binary operation, called as @p op(R, const T&) in chunks and @p op(R, R) to combine chunks.
+ */
+template <class T, class R, class BinaryOp>
+COMMON613_NODISCARD
+R parallelReduce(ThreadPool& pool, const T* input, std::size_t count, R identity, BinaryOp op,
+                 std::size_t grain = defaultGrainSize) {
+  grain = std::max<std::size_t>(grain, 1);
+  std::vector<internal::ReduceSlot<R>> partials((count + grain - 1) / grain, internal::ReduceSlot<R>{identity});
+  internal::runChunks(pool, count, grain, 0,
+                      [input, &partials, &identity, &op](std::size_t chunk, std::size_t first, std::size_t last) {
+                        R partial = identity;
+                        for (std::size_t i = first; i < last; ++i) {
+                          partial = op(partial, input[i]);
+                        }
+                        partials[chunk].value = partial;
+                      });
+  R result = identity;
+  for (const auto& partial : partials) {
+    result = op(result, partial.value);
+  }
+  return result;
+}
+
+/// @overload
+template <class T, class R, class BinaryOp>
+COMMON613_NODISCARD
+R parallelReduce(const T* input, std::size_t count, R identity, BinaryOp op, std::size_t grain = defaultGrainSize) {
+  return parallelReduce(ThreadPool::instance(), input, count, std::move(identity), op, grain);
+}
+
+}
+
+#endif //COMMON613_THREAD_POOL_H
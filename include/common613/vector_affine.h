@@ -0,0 +1,346 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+/// @file
+/// @brief Integer affine transforms over @ref ArrNi, with batched application to point arrays.
+
+#pragma once
+#ifndef COMMON613_VECTOR_AFFINE_H
+#define COMMON613_VECTOR_AFFINE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <common613/assert.h>
+#include <common613/compat/cpp17.h>
+#include <common613/compat/simd.h>
+#include <common613/vector_arith_utils.h>
+#include <common613/vector_definitions.h>
+
+namespace common613 {
+
+/// @cond
+namespace internal {
+
+// Affine arithmetic is done in this unsigned type, so that it wraps around instead of overflowing.
+// It is at least as wide as unsigned int, or small types would be promoted to int and overflow again.
+template <class IntT>
+using AffineWord = std::common_type_t<std::make_unsigned_t<IntT>, unsigned>;
+
+}
+/// @endcond
+
+/**
+ * @brief An integer affine transform @c p->matrix*p+translation .
+ *
+ * Transforms compose with @c * like functions, i.e. @c (a*b)(p)==a(b(p)) , and everything is @c constexpr :
+ * @code
+ * constexpr auto turn = AffineNi<int, 2>::rotate90(0, 1) * AffineNi<int, 2>::mirror(1);
+ * static_assert(turn(Arr2i<false, int>::of(1, 2)) == Arr2i<false, int>::of(2, 1), "");
+ * @endcode
+ * @tparam IntT Underlying int type. Arithmetic wraps around in the width of @p IntT , like the SIMD kernels of
+ * @ref transformPoints, and never throws on overflow.
+ * @tparam N Dimensions.
+ */
+template <class IntT, std::size_t N>
+struct AffineNi {
+  /// @brief Point type.
+  using Point = ArrNi<false, IntT, N>;
+  /// @brief Vector type.
+  using Vector = ArrNi<true, IntT, N>;
+  /// @brief Matrix type, indexed as @c matrix[row][column] .
+  using Matrix = std::array<std::array<IntT, N>, N>;
+
+  /// @brief The linear part.
+  Matrix matrix;
+  /// @brief The translation applied after @ref matrix.
+  Vector translation;
+
+  /// @brief Returns the identity transform.
+  COMMON613_NODISCARD constexpr static AffineNi identity() {
+    AffineNi ret{};
+    for (std::size_t i = 0; i < N; ++i) {
+      ret.matrix[i][i] = 1;
+    }
+    return ret;
+  }
+
+  /// @brief Returns the transform adding @p offset .
+  COMMON613_NODISCARD constexpr static AffineNi fromTranslation(const Vector& offset) {
+    AffineNi ret = identity();
+    ret.translation = offset;
+    return ret;
+  }
+
+  /// @brief Returns the linear transform of @p linear .
+  COMMON613_NODISCARD constexpr static AffineNi fromMatrix(const Matrix& linear) {
+    return AffineNi{linear, Vector{}};
+  }
+
+  /// @brief Returns the transform moving component @c axes[i] of its input to component @c i .
+  COMMON613_NODISCARD constexpr static AffineNi fromPermutation(const std::array<std::size_t, N>& axes) {
+    AffineNi ret{};
+    for (std::size_t i = 0; i < N; ++i) {
+      COMMON613_REQUIRE_SILENT(axes[i] < N, "Axis {} is out of {} dimensions.", axes[i], N);
+      ret.matrix[i][axes[i]] = 1;
+    }
+    return ret;
+  }
+
+  /// @brief Returns the transform negating component @p axis .
+  COMMON613_NODISCARD constexpr static AffineNi mirror(std::size_t axis) {
+    COMMON613_REQUIRE_SILENT(axis < N, "Axis {} is out of {} dimensions.", axis, N);
+    AffineNi ret = identity();
+    ret.matrix[axis][axis] = -1;
+    return ret;
+  }
+
+  /// @brief Returns the rotation by @p quarterTurns quarter turns in the plane of two axes, turning @p from to @p to .
+  COMMON613_NODISCARD constexpr static AffineNi rotate90(std::size_t from, std::size_t to, int quarterTurns = 1) {
+    COMMON613_REQUIRE_SILENT(from < N && to < N && from != to, "Invalid plane of axes {} and {}.", from, to);
+    AffineNi turn = identity();
+    turn.matrix[from][from] = turn.matrix[to][to] = 0;
+    turn.matrix[to][from] = 1;
+    turn.matrix[from][to] = -1;
+    AffineNi ret = identity();
+    for (int i = 0; i < (quarterTurns % 4 + 4) % 4; ++i) {
+      ret = turn * ret;
+    }
+    return ret;
+  }
+
+  /// @brief Applies the transform to @p point .
+  COMMON613_NODISCARD constexpr Point operator()(const Point& point) const {
+    using Word = internal::AffineWord<IntT>;
+    Point ret{};
+    for (std::size_t r = 0; r < N; ++r) {
+      Word sum = static_cast<Word>(translation.arr[r]);
+      for (std::size_t c = 0; c < N; ++c) {
+        sum += static_cast<Word>(matrix[r][c]) * static_cast<Word>(point.arr[c]);
+      }
+      ret.arr[r] = static_cast<IntT>(sum);
+    }
+    return ret;
+  }
+
+  /// @brief Applies the linear part to @p vector , as translations do not move vectors.
+  COMMON613_NODISCARD constexpr Vector operator()(const Vector& vector) const {
+    using Word = internal::AffineWord<IntT>;
+    Vector ret{};
+    for (std::size_t r = 0; r < N; ++r) {
+      Word sum = 0;
+      for (std::size_t c = 0; c < N; ++c) {
+        sum += static_cast<Word>(matrix[r][c]) * static_cast<Word>(vector.arr[c]);
+      }
+      ret.arr[r] = static_cast<IntT>(sum);
+    }
+    return ret;
+  }
+
+  /// @brief Returns whether @ref matrix only permutes components and flips their signs.
+  COMMON613_NODISCARD constexpr bool isSignedPermutation() const {
+    std::array<bool, N> used{};
+    for (std::size_t r = 0; r < N; ++r) {
+      std::size_t nonZeros = 0;
+      for (std::size_t c = 0; c < N; ++c) {
+        if (matrix[r][c] == 0) {
+          continue;
+        }
+        if ((matrix[r][c] != 1 && matrix[r][c] != -1) || used[c]) {
+          return false;
+        }
+        used[c] = true;
+        ++nonZeros;
+      }
+      if (nonZeros != 1) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+/// @brief Shortcut for 2-D @ref AffineNi.
+template <class IntType>
+using Affine2i = AffineNi<IntType, 2>;
+
+/// @brief Shortcut for 3-D @ref AffineNi.
+template <class IntType>
+using Affine3i = AffineNi<IntType, 3>;
+
+/// @related AffineNi
+/// @brief Composes two transforms, applying @p rhs first.
+template <class IntT, std::size_t N>
+COMMON613_NODISCARD
+constexpr AffineNi<IntT, N> operator*(const AffineNi<IntT, N>& lhs, const AffineNi<IntT, N>& rhs) {
+  using Word = internal::AffineWord<IntT>;
+  AffineNi<IntT, N> ret{};
+  for (std::size_t r = 0; r < N; ++r) {
+    for (std::size_t c = 0; c < N; ++c) {
+      Word sum = 0;
+      for (std::size_t k = 0; k < N; ++k) {
+        sum += static_cast<Word>(lhs.matrix[r][k]) * static_cast<Word>(rhs.matrix[k][c]);
+      }
+      ret.matrix[r][c] = static_cast<IntT>(sum);
+    }
+  }
+  const auto moved = lhs(rhs.translation);
+  for (std::size_t r = 0; r < N; ++r) {
+    ret.translation.arr[r] = static_cast<IntT>(static_cast<Word>(moved.arr[r]) +
+                                               static_cast<Word>(lhs.translation.arr[r]));
+  }
+  return ret;
+}
+
+/// @related AffineNi
+template <class IntT, std::size_t N>
+COMMON613_NODISCARD
+constexpr bool operator==(const AffineNi<IntT, N>& lhs, const AffineNi<IntT, N>& rhs) {
+  for (std::size_t r = 0; r < N; ++r) {
+    for (std::size_t c = 0; c < N; ++c) {
+      if (lhs.matrix[r][c] != rhs.matrix[r][c]) {
+        return false;
+      }
+    }
+  }
+  return lhs.translation == rhs.translation;
+}
+
+/// @related AffineNi
+template <class IntT, std::size_t N>
+COMMON613_NODISCARD
+constexpr bool operator!=(const AffineNi<IntT, N>& lhs, const AffineNi<IntT, N>& rhs) {
+  return !(lhs == rhs);
+}
+
+/// @cond
+namespace internal {
+
+// Output component r is sign[r] * input component source[r] + translation[r].
+template <class IntT, std::size_t N>
+struct SignedPermutation {
+  std::array<std::size_t, N> source;
+  std::array<IntT, N> sign;
+};
+
+template <class IntT, std::size_t N>
+SignedPermutation<IntT, N> toSignedPermutation(const AffineNi<IntT, N>& transform) {
+  SignedPermutation<IntT, N> ret{};
+  for (std::size_t r = 0; r < N; ++r) {
+    for (std::size_t c = 0; c < N; ++c) {
+      if (transform.matrix[r][c] != 0) {
+        ret.source[r] = c;
+        ret.sign[r] = transform.matrix[r][c];
+      }
+    }
+  }
+  return ret;
+}
+
+template <class IntT, std::size_t N>
+void transformPermuted(const AffineNi<IntT, N>& transform, const ArrNi<false, IntT, N>* points, std::size_t count,
+                       ArrNi<false, IntT, N>* output) {
+  using Word = AffineWord<IntT>;
+  const SignedPermutation<IntT, N> permutation = toSignedPermutation(transform);
+  for (std::size_t i = 0; i < count; ++i) {
+    ArrNi<false, IntT, N> ret;
+    for (std::size_t r = 0; r < N; ++r) {
+      ret.arr[r] = static_cast<IntT>(static_cast<Word>(permutation.sign[r]) *
+                                     static_cast<Word>(points[i].arr[permutation.source[r]]) +
+                                     static_cast<Word>(transform.translation.arr[r]));
+    }
+    output[i] = ret;
+  }
+}
+
+template <class IntT, std::size_t N>
+void transformGeneral(const AffineNi<IntT, N>& transform, const ArrNi<false, IntT, N>* points, std::size_t count,
+                      ArrNi<false, IntT, N>* output) {
+  for (std::size_t i = 0; i < count; ++i) {
+    output[i] = transform(points[i]);
+  }
+}
+
+#ifdef COMMON613_HAS_SSE2
+// Points of 2 x int32 either keep or swap their components with pshufd, and signs are flipped as (v ^ m) - m.
+inline void transformPermuted(const AffineNi<std::int32_t, 2>& transform, const ArrNi<false, std::int32_t, 2>* points,
+                              std::size_t count, ArrNi<false, std::int32_t, 2>* output) {
+  using Point = ArrNi<false, std::int32_t, 2>;
+  COMMON613_CHECK_BINARY_USABLE(Point);
+  const SignedPermutation<std::int32_t, 2> permutation = toSignedPermutation(transform);
+  const bool swapped = permutation.source[0] == 1;
+  const std::int32_t flipX = permutation.sign[0] < 0 ? -1 : 0, flipY = permutation.sign[1] < 0 ? -1 : 0;
+  const std::int32_t tx = transform.translation.x(), ty = transform.translation.y();
+  auto* in = reinterpret_cast<const unsigned char*>(points);
+  auto* out = reinterpret_cast<unsigned char*>(output);
+  std::size_t i = 0;
+# ifdef COMMON613_HAS_AVX2
+  const __m256i flip8 = _mm256_setr_epi32(flipX, flipY, flipX, flipY, flipX, flipY, flipX, flipY);
+  const __m256i translation8 = _mm256_setr_epi32(tx, ty, tx, ty, tx, ty, tx, ty);
+  for (; i + 4 <= count; i += 4) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i * sizeof(Point)));
+    v = swapped ? _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)) : v;
+    v = _mm256_add_epi32(_mm256_sub_epi32(_mm256_xor_si256(v, flip8), flip8), translation8);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * sizeof(Point)), v);
+  }
+# endif
+  const __m128i flip4 = _mm_setr_epi32(flipX, flipY, flipX, flipY);
+  const __m128i translation4 = _mm_setr_epi32(tx, ty, tx, ty);
+  for (; i + 2 <= count; i += 2) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * sizeof(Point)));
+    v = swapped ? _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)) : v;
+    v = _mm_add_epi32(_mm_sub_epi32(_mm_xor_si128(v, flip4), flip4), translation4);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * sizeof(Point)), v);
+  }
+  transformPermuted<std::int32_t, 2>(transform, points + i, count - i, output + i);
+}
+#endif
+
+#ifdef COMMON613_HAS_AVX2
+// Points of 2 x int32 are transformed 4 at a time as x * column 0 + y * column 1 + translation.
+inline void transformGeneral(const AffineNi<std::int32_t, 2>& transform, const ArrNi<false, std::int32_t, 2>* points,
+                             std::size_t count, ArrNi<false, std::int32_t, 2>* output) {
+  using Point = ArrNi<false, std::int32_t, 2>;
+  COMMON613_CHECK_BINARY_USABLE(Point);
+  const auto& m = transform.matrix;
+  const std::int32_t tx = transform.translation.x(), ty = transform.translation.y();
+  const __m256i column0 = _mm256_setr_epi32(m[0][0], m[1][0], m[0][0], m[1][0], m[0][0], m[1][0], m[0][0], m[1][0]);
+  const __m256i column1 = _mm256_setr_epi32(m[0][1], m[1][1], m[0][1], m[1][1], m[0][1], m[1][1], m[0][1], m[1][1]);
+  const __m256i translation = _mm256_setr_epi32(tx, ty, tx, ty, tx, ty, tx, ty);
+  auto* in = reinterpret_cast<const unsigned char*>(points);
+  auto* out = reinterpret_cast<unsigned char*>(output);
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i * sizeof(Point)));
+    __m256i xs = _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 2, 0, 0));
+    __m256i ys = _mm256_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 1, 1));
+    __m256i ret = _mm256_add_epi32(_mm256_mullo_epi32(xs, column0), _mm256_mullo_epi32(ys, column1));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * sizeof(Point)), _mm256_add_epi32(ret, translation));
+  }
+  transformGeneral<std::int32_t, 2>(transform, points + i, count - i, output + i);
+}
+#endif
+
+}
+/// @endcond
+
+/**
+ * @brief Applies @p transform to @p count points, writing them to @p output , which may be @p points itself.
+ * @note Axis swaps, mirrors and rotations by quarter turns are detected and done without multiplication.
+ * Points of 2 x @c int32_t are transformed with SSE2/AVX2.
+ */
+template <class IntT, std::size_t N>
+void transformPoints(const AffineNi<IntT, N>& transform, const ArrNi<false, IntT, N>* points, std::size_t count,
+                     ArrNi<false, IntT, N>* output) {
+  if (transform.isSignedPermutation()) {
+    internal::transformPermuted(transform, points, count, output);
+  } else {
+    internal::transformGeneral(transform, points, count, output);
+  }
+}
+
+}
+
+#endif //COMMON613_VECTOR_AFFINE_H
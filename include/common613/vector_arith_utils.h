@@ -41,6 +41,69 @@ constexpr ArrNi<RET, IntT, N> binaryHelper(const ArrNi<A, IntT, N>& lhs, const A
   return ArrNi<RET, IntT, N>::of(f(lhs.arr[IND], rhs.arr[IND])...);
 }
 
+template <bool RET, class IntT, std::size_t N, std::size_t... IND>
+COMMON613_NODISCARD
+constexpr ArrNi<RET, IntT, N> unpackHelper(typename PackedWord<IntT, N>::Word word,
+                                           std::integer_sequence<std::size_t, IND...>) {
+  return ArrNi<RET, IntT, N>{{PackedWord<IntT, N>::template lane<IND>(word)...}};
+}
+
+template <bool A, bool B, class IntT, std::size_t N>
+COMMON613_NODISCARD
+constexpr bool equalDispatch(const ArrNi<A, IntT, N>& lhs, const ArrNi<B, IntT, N>& rhs, std::false_type) {
+  return equalHelper(lhs, rhs, std::make_index_sequence<N>{});
+}
+
+template <bool A, bool B, class IntT, std::size_t N>
+COMMON613_NODISCARD
+constexpr bool equalDispatch(const ArrNi<A, IntT, N>& lhs, const ArrNi<B, IntT, N>& rhs, std::true_type) {
+  return PackedWord<IntT, N>::pack(lhs.arr) == PackedWord<IntT, N>::pack(rhs.arr);
+}
+
+template <bool RET, bool A, bool B, class IntT, std::size_t N, class BinaryFunc>
+COMMON613_NODISCARD
+constexpr ArrNi<RET, IntT, N> additiveDispatch(const ArrNi<A, IntT, N>& lhs, const ArrNi<B, IntT, N>& rhs, BinaryFunc&& f,
+                                          std::false_type) {
+  return binaryHelper<RET>(lhs, rhs, std::forward<BinaryFunc>(f), std::make_index_sequence<N>{});
+}
+
+// Lane-wise addition without carries across lanes. Falls back to the checked path on overflow so that it throws.
+template <bool RET, bool A, bool B, class IntT, std::size_t N>
+COMMON613_NODISCARD
+constexpr ArrNi<RET, IntT, N> additiveDispatch(const ArrNi<A, IntT, N>& lhs, const ArrNi<B, IntT, N>& rhs, std::plus<>,
+                                          std::true_type) {
+  using Packed = PackedWord<IntT, N>;
+  using Word = typename Packed::Word;
+  const Word h = Packed::highBits();
+  const Word a = Packed::pack(lhs.arr), b = Packed::pack(rhs.arr);
+  const Word sum = ((a & ~h) + (b & ~h)) ^ ((a ^ b) & h);
+  const Word overflow = std::is_signed<IntT>::value ? (~(a ^ b) & (a ^ sum) & h) : (((a & b) | ((a | b) & ~sum)) & h);
+  if (overflow != 0) {
+    return binaryHelper<RET>(lhs, rhs, std::plus<>{}, std::make_index_sequence<N>{});
+  }
+  return unpackHelper<RET, IntT, N>(sum, std::make_index_sequence<N>{});
+}
+
+// Lane-wise subtraction without borrows across lanes. Falls back to the checked path on overflow so that it throws.
+template <bool RET, bool A, bool B, class IntT, std::size_t N>
+COMMON613_NODISCARD
+constexpr ArrNi<RET, IntT, N> additiveDispatch(const ArrNi<A, IntT, N>& lhs, const ArrNi<B, IntT, N>& rhs, std::minus<>,
+                                          std::true_type) {
+  using Packed = PackedWord<IntT, N>;
+  using Word = typename Packed::Word;
+  const Word h = Packed::highBits();
+  const Word a = Packed::pack(lhs.arr), b = Packed::pack(rhs.arr);
+  const Word diff = ((a | h) - (b & ~h)) ^ ((a ^ ~b) & h);
+  const Word overflow = std::is_signed<IntT>::value ? ((a ^ b) & (a ^ diff) & h) : (((~a & b) | (~(a ^ b) & diff)) & h);
+  if (overflow != 0) {
+    return binaryHelper<RET>(lhs, rhs, std::minus<>{}, std::make_index_sequence<N>{});
+  }
+  return unpackHelper<RET, IntT, N>(diff, std::make_index_sequence<N>{});
+}
+
+template <class IntT, std::size_t N>
+using IsPacked = std::integral_constant<bool, PackedWord<IntT, N>::value>;
+
 }
 /// @endcond
 
@@ -48,7 +111,7 @@ constexpr ArrNi<RET, IntT, N> binaryHelper(const ArrNi<A, IntT, N>& lhs, const A
 template <bool A, class IntT, std::size_t N>
 COMMON613_NODISCARD
 constexpr bool operator==(const ArrNi<A, IntT, N>& lhs, const ArrNi<A, IntT, N>& rhs) {
-  return internal::equalHelper(lhs, rhs, std::make_index_sequence<N>{});
+  return internal::equalDispatch(lhs, rhs, internal::IsPacked<IntT, N>{});
 }
 
 /// @related ArrNi
@@ -63,7 +126,7 @@ template <bool A, bool B, class IntT, std::size_t N>
 COMMON613_NODISCARD
 constexpr ArrNi<A && B, IntT, N> operator+(const ArrNi<A, IntT, N>& lhs, const ArrNi<B, IntT, N>& rhs) {
   static_assert(A || B, "Point + Point is not allowed.");
-  return internal::binaryHelper<A && B>(lhs, rhs, std::plus<>{}, std::make_index_sequence<N>{});
+  return internal::additiveDispatch<A && B>(lhs, rhs, std::plus<>{}, internal::IsPacked<IntT, N>{});
 }
 
 /// @related ArrNi
@@ -71,7 +134,7 @@ template <bool A, bool B, class IntT, std::size_t N>
 COMMON613_NODISCARD
 constexpr ArrNi<A == B, IntT, N> operator-(const ArrNi<A, IntT, N>& lhs, const ArrNi<B, IntT, N>& rhs) {
   static_assert(!A || B, "Vector - Point is not allowed.");
-  return internal::binaryHelper<A == B>(lhs, rhs, std::minus<>(), std::make_index_sequence<N>{});
+  return internal::additiveDispatch<A == B>(lhs, rhs, std::minus<>(), internal::IsPacked<IntT, N>{});
 }
 
 /// @related ArrNi
@@ -0,0 +1,266 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+/// @file
+/// @brief Axis-aligned integer boxes over @ref ArrNi, with batched containment tests.
+
+#pragma once
+#ifndef COMMON613_VECTOR_BOX_H
+#define COMMON613_VECTOR_BOX_H
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <common613/struct_size_check.h>
+#include <common613/compat/cpp17.h>
+#include <common613/compat/simd.h>
+#include <common613/vector_arith_utils.h>
+#include <common613/vector_definitions.h>
+
+namespace common613 {
+
+/// @cond
+namespace internal {
+
+// origin <= point < origin + extent in one unsigned comparison, given a non-negative extent.
+template <class IntT>
+constexpr bool inRange(IntT point, IntT origin, IntT extent) {
+  using UIntT = std::make_unsigned_t<IntT>;
+  return static_cast<UIntT>(static_cast<UIntT>(point) - static_cast<UIntT>(origin)) < static_cast<UIntT>(extent);
+}
+
+template <class IntT, std::size_t N, std::size_t... IND>
+constexpr bool containsHelper(const ArrNi<false, IntT, N>& origin, const ArrNi<true, IntT, N>& extent,
+                              const ArrNi<false, IntT, N>& point, std::integer_sequence<std::size_t, IND...>) {
+  return COMMON613_FOLD_RIGHT((inRange(point.arr[IND], origin.arr[IND], extent.arr[IND])), &);
+}
+
+template <class IntT, std::size_t N, std::size_t... IND>
+constexpr bool anyNonPositive(const ArrNi<true, IntT, N>& extent, std::integer_sequence<std::size_t, IND...>) {
+  return COMMON613_FOLD_RIGHT((extent.arr[IND] <= 0), ||);
+}
+
+template <class IntT, std::size_t N, std::size_t... IND>
+constexpr std::uint64_t productHelper(const ArrNi<true, IntT, N>& extent, std::integer_sequence<std::size_t, IND...>) {
+  return COMMON613_FOLD_RIGHT((static_cast<std::uint64_t>(extent.arr[IND])), *);
+}
+
+}
+/// @endcond
+
+/**
+ * @brief An axis-aligned box of integer points in [ @ref origin, @ref origin + @ref extent ).
+ * @tparam IntT Underlying int type.
+ * @tparam N Dimensions.
+ * @note Extents are expected to be non-negative. A box with any zero extent is empty.
+ */
+template <class IntT, std::size_t N>
+struct BoxNi {
+  /// @brief Point type.
+  using Point = ArrNi<false, IntT, N>;
+  /// @brief Vector type.
+  using Vector = ArrNi<true, IntT, N>;
+
+  /// @brief The minimum corner, inclusive.
+  Point origin;
+  /// @brief Size along each axis.
+  Vector extent;
+
+  COMMON613_INJECT_SIZE_FIELD(sizeof(IntT) * N * 2);
+
+  /// @brief Constructs the box [ @p min , @p max ). Axes where @p max is below @p min get zero extent.
+  COMMON613_NODISCARD constexpr static BoxNi fromCorners(const Point& min, const Point& max) {
+    return BoxNi{min, internal::binaryHelper<false>(max, min, [](IntT a, IntT b) { return std::max(a, b); },
+                                                    std::make_index_sequence<N>{}) - min};
+  }
+
+  /// @brief Returns the maximum corner, exclusive.
+  COMMON613_NODISCARD constexpr Point end() const { return origin + extent; }
+
+  /// @brief Returns whether the box contains no point.
+  COMMON613_NODISCARD constexpr bool empty() const {
+    return internal::anyNonPositive(extent, std::make_index_sequence<N>{});
+  }
+
+  /// @brief Returns the count of points in the box.
+  COMMON613_NODISCARD constexpr std::uint64_t volume() const {
+    return empty() ? 0 : internal::productHelper(extent, std::make_index_sequence<N>{});
+  }
+
+  /// @brief Returns whether @p point is in the box.
+  COMMON613_NODISCARD constexpr bool contains(const Point& point) const {
+    return internal::containsHelper(origin, extent, point, std::make_index_sequence<N>{});
+  }
+
+  /// @brief Returns whether @p other is entirely in the box. An empty box is contained in any box.
+  COMMON613_NODISCARD constexpr bool contains(const BoxNi& other) const {
+    return other.empty() || intersect(other) == other;
+  }
+
+  /// @brief Returns the common part of two boxes, which is empty with zero extent if they do not overlap.
+  COMMON613_NODISCARD constexpr BoxNi intersect(const BoxNi& other) const {
+    const auto min = internal::binaryHelper<false>(origin, other.origin, [](IntT a, IntT b) { return std::max(a, b); },
+                                                   std::make_index_sequence<N>{});
+    const auto max = internal::binaryHelper<false>(end(), other.end(), [](IntT a, IntT b) { return std::min(a, b); },
+                                                   std::make_index_sequence<N>{});
+    return BoxNi{min, internal::binaryHelper<true>(max, min, [](IntT a, IntT b) { return a > b ? a - b : 0; },
+                                                   std::make_index_sequence<N>{})};
+  }
+
+  /// @brief Returns the smallest box containing both boxes. Empty boxes are ignored.
+  COMMON613_NODISCARD constexpr BoxNi unite(const BoxNi& other) const {
+    if (empty()) {
+      return other;
+    }
+    if (other.empty()) {
+      return *this;
+    }
+    return fromCorners(
+        internal::binaryHelper<false>(origin, other.origin, [](IntT a, IntT b) { return std::min(a, b); },
+                                      std::make_index_sequence<N>{}),
+        internal::binaryHelper<false>(end(), other.end(), [](IntT a, IntT b) { return std::max(a, b); },
+                                      std::make_index_sequence<N>{}));
+  }
+};
+
+/// @brief Shortcut for 2-D @ref BoxNi.
+template <class IntType>
+using Box2i = BoxNi<IntType, 2>;
+
+/// @brief Shortcut for 3-D @ref BoxNi.
+template <class IntType>
+using Box3i = BoxNi<IntType, 3>;
+
+/// @related BoxNi
+template <class IntT, std::size_t N>
+COMMON613_NODISCARD
+constexpr bool operator==(const BoxNi<IntT, N>& lhs, const BoxNi<IntT, N>& rhs) {
+  return lhs.origin == rhs.origin && lhs.extent == rhs.extent;
+}
+
+/// @related BoxNi
+template <class IntT, std::size_t N>
+COMMON613_NODISCARD
+constexpr bool operator!=(const BoxNi<IntT, N>& lhs, const BoxNi<IntT, N>& rhs) {
+  return !(lhs == rhs);
+}
+
+/// @cond
+namespace internal {
+
+// Bit i is set if box contains points[i], for count <= 64.
+template <class IntT, std::size_t N>
+std::uint64_t containsBits(const BoxNi<IntT, N>& box, const ArrNi<false, IntT, N>* points, std::size_t count) {
+  std::uint64_t bits = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    bits |= static_cast<std::uint64_t>(box.contains(points[i])) << i;
+  }
+  return bits;
+}
+
+#ifdef COMMON613_HAS_SSE2
+// Points of 2 x int32 are tested 4 (AVX2) or 2 (SSE2) at a time, comparing offsets and extents as unsigned.
+inline std::uint64_t containsBits(const BoxNi<std::int32_t, 2>& box, const ArrNi<false, std::int32_t, 2>* points,
+                                  std::size_t count) {
+  using Point = ArrNi<false, std::int32_t, 2>;
+  COMMON613_CHECK_BINARY_USABLE(Point);
+  std::uint64_t bits = 0;
+  std::size_t i = 0;
+# ifdef COMMON613_HAS_AVX2
+  const __m256i sign8 = _mm256_set1_epi32(INT32_MIN);
+  const __m256i origin8 = _mm256_setr_epi32(box.origin.x(), box.origin.y(), box.origin.x(), box.origin.y(),
+                                            box.origin.x(), box.origin.y(), box.origin.x(), box.origin.y());
+  const __m256i extent8 = _mm256_xor_si256(_mm256_setr_epi32(
+      box.extent.x(), box.extent.y(), box.extent.x(), box.extent.y(),
+      box.extent.x(), box.extent.y(), box.extent.x(), box.extent.y()), sign8);
+  for (; i + 4 <= count; i += 4) {
+    __m256i offset = _mm256_sub_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(points + i)), origin8);
+    __m256i inside = _mm256_cmpgt_epi32(extent8, _mm256_xor_si256(offset, sign8));
+    auto lanes = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(inside)));
+    lanes &= lanes >> 1;
+    unsigned pointBits = (lanes & 1) | ((lanes >> 1) & 2) | ((lanes >> 2) & 4) | ((lanes >> 3) & 8);
+    bits |= static_cast<std::uint64_t>(pointBits) << i;
+  }
+# endif
+  const __m128i sign4 = _mm_set1_epi32(INT32_MIN);
+  const __m128i origin4 = _mm_setr_epi32(box.origin.x(), box.origin.y(), box.origin.x(), box.origin.y());
+  const __m128i extent4 = _mm_xor_si128(
+      _mm_setr_epi32(box.extent.x(), box.extent.y(), box.extent.x(), box.extent.y()), sign4);
+  for (; i + 2 <= count; i += 2) {
+    __m128i offset = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(points + i)), origin4);
+    __m128i inside = _mm_cmplt_epi32(_mm_xor_si128(offset, sign4), extent4);
+    auto lanes = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(inside)));
+    lanes &= lanes >> 1;
+    unsigned pointBits = (lanes & 1) | ((lanes >> 1) & 2);
+    bits |= static_cast<std::uint64_t>(pointBits) << i;
+  }
+  for (; i < count; ++i) {
+    bits |= static_cast<std::uint64_t>(box.contains(points[i])) << i;
+  }
+  return bits;
+}
+#endif
+
+// Bit i is set if boxes[i] contains point, for count <= 64.
+template <class IntT, std::size_t N>
+std::uint64_t containingBits(const BoxNi<IntT, N>* boxes, std::size_t count, const ArrNi<false, IntT, N>& point) {
+  std::uint64_t bits = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    bits |= static_cast<std::uint64_t>(boxes[i].contains(point)) << i;
+  }
+  return bits;
+}
+
+#ifdef COMMON613_HAS_SSE2
+// Boxes of 2 x int32 are loaded whole as (origin, extent), and the extent half is moved under the offset half.
+inline std::uint64_t containingBits(const BoxNi<std::int32_t, 2>* boxes, std::size_t count,
+                                    const ArrNi<false, std::int32_t, 2>& point) {
+  using Box = BoxNi<std::int32_t, 2>;
+  COMMON613_CHECK_BINARY_USABLE(Box);
+  const __m128i sign = _mm_set1_epi32(INT32_MIN);
+  const __m128i point4 = _mm_setr_epi32(point.x(), point.y(), point.x(), point.y());
+  std::uint64_t bits = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    __m128i box = _mm_loadu_si128(reinterpret_cast<const __m128i*>(boxes + i));
+    __m128i offset = _mm_xor_si128(_mm_sub_epi32(point4, box), sign);
+    __m128i extent = _mm_xor_si128(_mm_shuffle_epi32(box, _MM_SHUFFLE(3, 2, 3, 2)), sign);
+    auto lanes = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(offset, extent))));
+    bits |= static_cast<std::uint64_t>((lanes & 3) == 3) << i;
+  }
+  return bits;
+}
+#endif
+
+}
+/// @endcond
+
+/**
+ * @brief Tests @p count points against @p box , setting bit @c i%64 of @p mask[i/64] if @p points[i] is inside.
+ * @param mask Output of @c (count+63)/64 words. Bits beyond @p count are cleared.
+ * @note Points of 2 x @c int32_t are tested with SSE2/AVX2.
+ */
+template <class IntT, std::size_t N>
+void containsMask(const BoxNi<IntT, N>& box, const ArrNi<false, IntT, N>* points, std::size_t count,
+                  std::uint64_t* mask) {
+  for (std::size_t base = 0; base < count; base += 64) {
+    mask[base / 64] = internal::containsBits(box, points + base, std::min<std::size_t>(64, count - base));
+  }
+}
+
+/**
+ * @brief Tests @p point against @p count boxes, setting bit @c i%64 of @p mask[i/64] if @p boxes[i] contains it.
+ * @param mask Output of @c (count+63)/64 words. Bits beyond @p count are cleared.
+ * @note Boxes of 2 x @c int32_t are tested with SSE2.
+ */
+template <class IntT, std::size_t N>
+void containingMask(const BoxNi<IntT, N>* boxes, std::size_t count, const ArrNi<false, IntT, N>& point,
+                    std::uint64_t* mask) {
+  for (std::size_t base = 0; base < count; base += 64) {
+    mask[base / 64] = internal::containingBits(boxes + base, std::min<std::size_t>(64, count - base), point);
+  }
+}
+
+}
+
+#endif //COMMON613_VECTOR_BOX_H
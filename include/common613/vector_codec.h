@@ -0,0 +1,397 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+/// @file
+/// @brief Compact encoding for sequences of integer vectors, as zigzag deltas in stream-vbyte or varint layout.
+
+#pragma once
+#ifndef COMMON613_VECTOR_CODEC_H
+#define COMMON613_VECTOR_CODEC_H
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include <common613/assert.h>
+#include <common613/file_utils.h>
+#include <common613/memory.h>
+#include <common613/struct_size_check.h>
+#include <common613/compat/cpp17.h>
+#include <common613/compat/simd.h>
+#include <common613/vector_definitions.h>
+
+namespace common613 {
+
+/// @cond
+namespace internal {
+
+template <class ArrT>
+struct DeltaCoding {
+  using IntT = typename ArrT::valueType;
+  using UIntT = std::make_unsigned_t<IntT>;
+  // Codes of up to 32 bits use stream-vbyte, and wider ones use LEB128 varints.
+  using Code = std::conditional_t<sizeof(IntT) <= 4, std::uint32_t, std::uint64_t>;
+  constexpr static const unsigned bits = sizeof(IntT) * 8;
+
+  // Deltas wrap around in the width of IntT, so that any sequence round-trips exactly.
+  static Code encode(IntT current, IntT previous) {
+    auto delta = static_cast<UIntT>(static_cast<UIntT>(current) - static_cast<UIntT>(previous));
+    auto sign = static_cast<UIntT>(UIntT(0) - static_cast<UIntT>(delta >> (bits - 1)));
+    return static_cast<UIntT>(static_cast<UIntT>(delta << 1) ^ sign);
+  }
+
+  static IntT decode(Code code, IntT previous) {
+    auto zigzag = static_cast<UIntT>(code);
+    auto delta = static_cast<UIntT>(static_cast<UIntT>(zigzag >> 1) ^ static_cast<UIntT>(UIntT(0) - (zigzag & 1)));
+    return static_cast<IntT>(static_cast<UIntT>(static_cast<UIntT>(previous) + delta));
+  }
+};
+
+inline unsigned streamVByteLength(std::uint32_t value) {
+  return value < (1U << 8) ? 1 : value < (1U << 16) ? 2 : value < (1U << 24) ? 3 : 4;
+}
+
+// Shuffle masks and data lengths for every control byte, for decoding 4 values at once with pshufb.
+struct StreamVByteTables {
+  unsigned char shuffle[256][16];
+  unsigned char length[256];
+};
+
+constexpr StreamVByteTables makeStreamVByteTables() {
+  StreamVByteTables tables{};
+  for (unsigned control = 0; control < 256; ++control) {
+    unsigned char offset = 0;
+    for (unsigned i = 0; i < 4; ++i) {
+      unsigned length = ((control >> (2 * i)) & 3) + 1;
+      for (unsigned j = 0; j < 4; ++j) {
+        tables.shuffle[control][i * 4 + j] = j < length ? static_cast<unsigned char>(offset + j) : 0xFF;
+      }
+      offset = static_cast<unsigned char>(offset + length);
+    }
+    tables.length[control] = offset;
+  }
+  return tables;
+}
+
+inline const StreamVByteTables& streamVByteTables() {
+  static constexpr StreamVByteTables tables = makeStreamVByteTables();
+  return tables;
+}
+
+inline void encodeStreamVByte(const std::uint32_t* values, std::size_t count, Memory& output) {
+  if (count == 0) {
+    return;
+  }
+  const std::size_t controlSize = (count + 3) / 4;
+  std::size_t position = output.size();
+  // Resizing zero-fills the new bytes, which the control bits below are or-ed into.
+  output.resize(position + controlSize + count * 4);
+  unsigned char* control = output.data() + position;
+  unsigned char* data = control + controlSize;
+  for (std::size_t i = 0; i < count; ++i) {
+    unsigned length = streamVByteLength(values[i]);
+    control[i / 4] = static_cast<unsigned char>(control[i / 4] | ((length - 1) << (2 * (i % 4))));
+    for (unsigned j = 0; j < length; ++j) {
+      *data++ = static_cast<unsigned char>(values[i] >> (8 * j));
+    }
+  }
+  output.resize(data - output.data());
+}
+
+// Returns the end of consumed input, or nullptr if input is truncated.
+inline const unsigned char* decodeStreamVByte(const unsigned char* input, const unsigned char* last,
+                                              std::uint32_t* values, std::size_t count) {
+  const std::size_t controlSize = (count + 3) / 4;
+  if (static_cast<std::size_t>(last - input) < controlSize) {
+    return nullptr;
+  }
+  const unsigned char* control = input;
+  const unsigned char* data = input + controlSize;
+  std::size_t i = 0;
+#ifdef COMMON613_HAS_SSSE3
+  const StreamVByteTables& tables = streamVByteTables();
+  // Each step loads 16 bytes, so it stops while there may be fewer left.
+  for (; i + 4 <= count && last - data >= 16; i += 4) {
+    unsigned char bits = control[i / 4];
+    __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables.shuffle[bits]));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(values + i), _mm_shuffle_epi8(raw, mask));
+    data += tables.length[bits];
+  }
+#endif
+  for (; i < count; ++i) {
+    unsigned length = ((control[i / 4] >> (2 * (i % 4))) & 3) + 1;
+    if (static_cast<std::size_t>(last - data) < length) {
+      return nullptr;
+    }
+    std::uint32_t value = 0;
+    for (unsigned j = 0; j < length; ++j) {
+      value |= static_cast<std::uint32_t>(data[j]) << (8 * j);
+    }
+    values[i] = value;
+    data += length;
+  }
+  return data;
+}
+
+inline void encodeVarints(const std::uint64_t* values, std::size_t count, Memory& output) {
+  for (std::size_t i = 0; i < count; ++i) {
+    std::uint64_t value = values[i];
+    while (value >= 0x80) {
+      output.push_back(static_cast<unsigned char>(value | 0x80));
+      value >>= 7;
+    }
+    output.push_back(static_cast<unsigned char>(value));
+  }
+}
+
+// Returns the end of consumed input, or nullptr if input is truncated or malformed.
+inline const unsigned char* decodeVarints(const unsigned char* input, const unsigned char* last,
+                                          std::uint64_t* values, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    std::uint64_t value = 0;
+    for (unsigned shift = 0;; shift += 7) {
+      if (input == last || shift >= 64) {
+        return nullptr;
+      }
+      unsigned char byte = *input++;
+      value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) {
+        break;
+      }
+    }
+    values[i] = value;
+  }
+  return input;
+}
+
+// Fewest bytes encoding count codes: one data byte per code, plus 2 control bits per code in stream-vbyte.
+inline std::size_t minEncodedSize(std::uint32_t*, std::size_t count) {
+  return (count + 3) / 4 + count;
+}
+
+inline std::size_t minEncodedSize(std::uint64_t*, std::size_t count) {
+  return count;
+}
+
+inline void encodeCodes(const std::uint32_t* values, std::size_t count, Memory& output) {
+  encodeStreamVByte(values, count, output);
+}
+
+inline void encodeCodes(const std::uint64_t* values, std::size_t count, Memory& output) {
+  encodeVarints(values, count, output);
+}
+
+inline const unsigned char* decodeCodes(const unsigned char* input, const unsigned char* last,
+                                        std::uint32_t* values, std::size_t count) {
+  return decodeStreamVByte(input, last, values, count);
+}
+
+inline const unsigned char* decodeCodes(const unsigned char* input, const unsigned char* last,
+                                        std::uint64_t* values, std::size_t count) {
+  return decodeVarints(input, last, values, count);
+}
+
+}
+/// @endcond
+
+/**
+ * @brief Appends the encoding of @p count arrays from @p input to @p output .
+ *
+ * Each component is stored as the zigzag delta from the same component of the previous array (the first from 0).
+ * Components of up to 32 bits are laid out in stream-vbyte format (2-bit lengths grouped in control bytes ahead of
+ * 1-4 data bytes per value), which is decoded 4 values at a time with SSSE3 when available.
+ * Wider components are stored as LEB128 varints.
+ * @note The count is not stored, so it has to be passed to @ref decodeDeltas.
+ */
+template <class ArrT>
+void encodeDeltas(const ArrT* input, std::size_t count, Memory& output) {
+  using Coding = internal::DeltaCoding<ArrT>;
+  std::vector<typename Coding::Code> codes(count * ArrT::dimension);
+  ArrT previous{};
+  for (std::size_t i = 0; i < count; ++i) {
+    for (std::size_t j = 0; j < ArrT::dimension; ++j) {
+      codes[i * ArrT::dimension + j] = Coding::encode(input[i].arr[j], previous.arr[j]);
+    }
+    previous = input[i];
+  }
+  internal::encodeCodes(codes.data(), codes.size(), output);
+}
+
+/**
+ * @brief Returns whether @p count arrays may be encoded by @ref encodeDeltas in @p size bytes.
+ *
+ * @c false means the pair cannot come from @ref encodeDeltas , so @p count is not to be trusted for allocation.
+ */
+template <class ArrT>
+COMMON613_NODISCARD bool mayEncodeDeltas(std::size_t count, std::size_t size) {
+  using Code = typename internal::DeltaCoding<ArrT>::Code;
+  return count <= size && internal::minEncodedSize(static_cast<Code*>(nullptr), count * ArrT::dimension) <= size;
+}
+
+/**
+ * @brief Decodes @p count arrays encoded by @ref encodeDeltas from [ @p first, @p last ) into @p output .
+ * @return The end of consumed bytes.
+ */
+template <class ArrT>
+const unsigned char* decodeDeltas(const unsigned char* first, const unsigned char* last,
+                                  ArrT* output, std::size_t count) {
+  using Coding = internal::DeltaCoding<ArrT>;
+  if (count == 0) {
+    return first;
+  }
+  COMMON613_REQUIRE(mayEncodeDeltas<ArrT>(count, static_cast<std::size_t>(last - first)),
+                    "Too many arrays ({}) for an encoding in {} bytes.", count, last - first);
+  std::vector<typename Coding::Code> codes(count * ArrT::dimension);
+  const unsigned char* end = internal::decodeCodes(first, last, codes.data(), codes.size());
+  COMMON613_REQUIRE(end != nullptr, "Truncated or malformed encoding of {} arrays in {} bytes.", count, last - first);
+  ArrT previous{};
+  for (std::size_t i = 0; i < count; ++i) {
+    for (std::size_t j = 0; j < ArrT::dimension; ++j) {
+      previous.arr[j] = Coding::decode(codes[i * ArrT::dimension + j], previous.arr[j]);
+    }
+    output[i] = previous;
+  }
+  return end;
+}
+
+namespace file {
+
+/// @brief Header of each block written by @ref PointWriter.
+struct PointBlockHeader {
+  /// @brief Count of arrays in the block.
+  std::uint32_t count;
+  /// @brief Count of encoded bytes following the header.
+  std::uint32_t size;
+
+  COMMON613_INJECT_SIZE_FIELD(8);
+};
+COMMON613_CHECK_BINARY_USABLE(PointBlockHeader);
+
+/**
+ * @brief Writes arrays to a @ref File in delta-encoded blocks, see @ref encodeDeltas.
+ *
+ * Every block restarts the delta chain, so blocks can be decoded independently.
+ * Headers are written in host byte order, like @ref write.
+ */
+template <class ArrT>
+class PointWriter {
+public:
+  /// @brief Default count of arrays per block.
+  constexpr static const std::size_t defaultBlockSize = 1 << 16;
+
+  /// @brief Writes to @p file , which must outlive the writer.
+  explicit PointWriter(const File& file, std::size_t blockSize = defaultBlockSize)
+      : file(file), blockSize(blockSize == 0 ? 1 : blockSize) {
+    pending.reserve(this->blockSize);
+  }
+
+  PointWriter(const PointWriter&) = delete;
+  PointWriter& operator=(const PointWriter&) = delete;
+
+  /// @brief Flushes pending arrays, ignoring errors. Call @ref flush to get errors reported.
+  ~PointWriter() {
+    try {
+      flush();
+    } catch (...) {
+    }
+  }
+
+  /// @brief Appends @p count arrays from @p input .
+  void write(const ArrT* input, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+      pending.push_back(input[i]);
+      if (pending.size() == blockSize) {
+        flush();
+      }
+    }
+  }
+
+  /// @brief Writes pending arrays as a block.
+  void flush() {
+    if (pending.empty()) {
+      return;
+    }
+    encoded.clear();
+    encodeDeltas(pending.data(), pending.size(), encoded);
+    PointBlockHeader header{checked_cast<std::uint32_t>(pending.size()), checked_cast<std::uint32_t>(encoded.size())};
+    pending.clear();
+    file::write(file, &header);
+    file::write(file, encoded.data(), encoded.size());
+  }
+
+private:
+  const File& file;
+  std::size_t blockSize;
+  std::vector<ArrT> pending;
+  Memory encoded;
+};
+
+/// @brief Reads blocks written by @ref PointWriter from a @ref File.
+template <class ArrT>
+class PointReader {
+public:
+  /// @brief Reads from the current position of @p file , which must outlive the reader.
+  explicit PointReader(const File& file) : file(file) {}
+
+  /// @brief Replaces @p points with the arrays in the next block.
+  /// @return @c false if there is no more block.
+  bool readBlock(std::vector<ArrT>& points) {
+    PointBlockHeader header;
+    std::size_t countRead = file::read(file, &header, std::nothrow);
+    if (countRead == 0 && eof(file)) {
+      return false;
+    }
+    COMMON613_REQUIRE(countRead == 1, "Failed to read block header. Error code: {}.", std::ferror(file.get()));
+    COMMON613_REQUIRE(mayEncodeDeltas<ArrT>(header.count, header.size),
+                      "Corrupt block header: {} arrays in {} bytes.", header.count, header.size);
+    readEncoded(header.size);
+    points.resize(header.count);
+    const unsigned char* end = encoded.data() + encoded.size();
+    COMMON613_REQUIRE(decodeDeltas(encoded.data(), end, points.data(), points.size()) == end,
+                      "Corrupt block: {} arrays do not span its {} bytes.", header.count, header.size);
+    return true;
+  }
+
+private:
+  // Grows the buffer as bytes arrive, so that a corrupt size fails on a short read before a huge allocation.
+  void readEncoded(std::size_t size) {
+    constexpr std::size_t minChunk = 1 << 16;
+    encoded.clear();
+    while (encoded.size() < size) {
+      std::size_t position = encoded.size();
+      std::size_t chunk = std::min(size - position, std::max(position, minChunk));
+      encoded.resize(position + chunk);
+      std::size_t countRead = file::read(file, encoded.data() + position, std::nothrow, chunk);
+      COMMON613_REQUIRE(countRead == chunk, "Truncated block: {} of {} bytes read.", position + countRead, size);
+    }
+  }
+
+  const File& file;
+  Memory encoded;
+};
+
+/// @brief Writes @p count arrays from @p input to @p file with a @ref PointWriter.
+template <class ArrT>
+void writePoints(const File& file, const ArrT* input, std::size_t count) {
+  PointWriter<ArrT> writer(file);
+  writer.write(input, count);
+  writer.flush();
+}
+
+/// @brief Reads all arrays from @p file with a @ref PointReader.
+template <class ArrT>
+COMMON613_NODISCARD std::vector<ArrT> readPoints(const File& file) {
+  PointReader<ArrT> reader(file);
+  std::vector<ArrT> ret, block;
+  while (reader.readBlock(block)) {
+    ret.insert(ret.end(), block.begin(), block.end());
+  }
+  return ret;
+}
+
+}
+
+}
+
+#endif //COMMON613_VECTOR_CODEC_H
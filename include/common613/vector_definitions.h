@@ -10,6 +10,8 @@
 
 #include <array>
 #include <cstdint>
+#include <type_traits>
+#include <utility>
 #include <common613/struct_size_check.h>
 #include <common613/checked_cast.h>
 #include <common613/compat/cpp17.h>
@@ -32,6 +34,46 @@ template <>
 struct All<> {
   constexpr static const bool value = true;
 };
+
+// Packs small-integer arrays fitting in a 32/64-bit word, so that they can be processed in SWAR style.
+// Component i occupies bits [i * laneBits, (i + 1) * laneBits), independent of the byte order,
+// and compilers merge the shifts below into a single load/store on little-endian hosts.
+template <class IntT, std::size_t N, class Enabled = void>
+struct PackedWord {
+  constexpr static const bool value = false;
+};
+
+template <class IntT, std::size_t N>
+struct PackedWord<IntT, N, std::enable_if_t<std::is_integral<IntT>::value && !std::is_same<IntT, bool>::value &&
+    N >= 2 && (sizeof(IntT) * N == 4 || sizeof(IntT) * N == 8)>> {
+  constexpr static const bool value = true;
+  using Word = std::conditional_t<sizeof(IntT) * N == 4, std::uint32_t, std::uint64_t>;
+  using Lane = std::make_unsigned_t<IntT>;
+  constexpr static const std::size_t laneBits = sizeof(IntT) * 8;
+
+  // The highest bit of each lane.
+  constexpr static Word highBits() {
+    Word ret = 0;
+    for (std::size_t i = 0; i < N; ++i) {
+      ret |= Word(1) << (i * laneBits + laneBits - 1);
+    }
+    return ret;
+  }
+
+  template <std::size_t... IND>
+  constexpr static Word packHelper(const std::array<IntT, N>& arr, std::integer_sequence<std::size_t, IND...>) {
+    return COMMON613_FOLD_RIGHT((Word(static_cast<Lane>(arr[IND])) << (IND * laneBits)), |);
+  }
+
+  constexpr static Word pack(const std::array<IntT, N>& arr) {
+    return packHelper(arr, std::make_index_sequence<N>{});
+  }
+
+  template <std::size_t I>
+  constexpr static IntT lane(Word word) {
+    return static_cast<IntT>(static_cast<Lane>(word >> (I * laneBits)));
+  }
+};
 }
 /// @endcond
 
@@ -40,6 +82,8 @@ struct All<> {
  * @tparam Vec Whether it is a vector ( @c true ) or a point ( @c false ).
  * @tparam IntT Underlying int type.
  * @tparam N Dimensions.
+ * @note When all components fit in a 32/64-bit word (e.g. @c int16_t x 2 or @c int8_t x 4),
+ * @c == , @c + and @c - are performed on the packed word in SWAR style.
  */
 template <bool Vec, class IntT, std::size_t N>
 struct ArrNi {
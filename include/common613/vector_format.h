@@ -0,0 +1,223 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+/// @file
+/// @brief Text formatting and parsing for integer vectors, including a @c fmt::formatter.
+
+#pragma once
+#ifndef COMMON613_VECTOR_FORMAT_H
+#define COMMON613_VECTOR_FORMAT_H
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+#include <fmt/format.h>
+#include <common613/assert.h>
+#include <common613/compat/cpp17.h>
+#include <common613/compat/simd.h>
+#include <common613/compat/string_view.h>
+#include <common613/vector_definitions.h>
+
+namespace common613 {
+
+/// @cond
+namespace internal {
+
+inline bool isSeparator(char c) {
+  return c == ' ' || c == ',' || c == '\t' || c == '\n' || c == '\r' || c == '(' || c == ')' || c == ';';
+}
+
+inline bool isDigit(char c) {
+  return static_cast<unsigned char>(c - '0') < 10;
+}
+
+// Count of leading decimal digits in the 8 bytes loaded little-endian in word, after subtracting '0' from each byte.
+// Borrows and carries only flow towards later bytes, so bytes before the first non-digit are intact.
+inline unsigned leadingDigits(std::uint64_t digits) {
+  std::uint64_t nonDigits = (digits | (digits + 0x0606060606060606ULL)) & 0xF0F0F0F0F0F0F0F0ULL;
+  if (nonDigits == 0) {
+    return 8;
+  }
+  auto low = static_cast<std::uint32_t>(nonDigits);
+  if (low != 0) {
+    return countTrailingZeros(low) / 8;
+  }
+  return 4 + countTrailingZeros(static_cast<std::uint32_t>(nonDigits >> 32)) / 8;
+}
+
+// Converts 8 digits (after subtracting '0'), the first one in the lowest byte, into their value in 3 multiplications.
+inline std::uint32_t eightDigitsValue(std::uint64_t digits) {
+  digits = (digits * 10 + (digits >> 8)) & 0x00FF00FF00FF00FFULL;
+  digits = (digits * 100 + (digits >> 16)) & 0x0000FFFF0000FFFFULL;
+  return static_cast<std::uint32_t>(digits * 10000 + (digits >> 32));
+}
+
+// Parses a decimal integer at [first, last). Up to 8 digits are parsed at once in SWAR style,
+// and longer numbers or ends of buffers go through std::from_chars.
+// A plus sign before a digit is skipped, since fmt writes one with "{:+}" while std::from_chars rejects it.
+template <class IntT>
+std::from_chars_result parseInteger(const char* first, const char* last, IntT& value) {
+  first += last - first >= 2 && *first == '+' && isDigit(first[1]);
+#if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_M_X64) || defined(_M_IX86)
+  const char* p = first;
+  bool negative = std::is_signed<IntT>::value && p != last && *p == '-';
+  p += negative;
+  if (last - p >= 9) {
+    std::uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    word -= 0x3030303030303030ULL;
+    unsigned count = leadingDigits(word);
+    if (count != 0 && (count != 8 || !isDigit(p[8]))) {
+      std::uint64_t magnitude = eightDigitsValue(word << (8 * (8 - count)));
+      using Wide = std::conditional_t<std::is_signed<IntT>::value, std::int64_t, std::uint64_t>;
+      Wide wide = negative ? -static_cast<Wide>(magnitude) : static_cast<Wide>(magnitude);
+      if (wide < static_cast<Wide>(std::numeric_limits<IntT>::min()) ||
+          wide > static_cast<Wide>(std::numeric_limits<IntT>::max())) {
+        // Like std::from_chars, points past the digits when the value is out of range.
+        return {p + count, std::errc::result_out_of_range};
+      }
+      value = static_cast<IntT>(wide);
+      return {p + count, std::errc()};
+    }
+  }
+#endif
+  return std::from_chars(first, last, value);
+}
+
+}
+/// @endcond
+
+/**
+ * @brief Writes @p operand into [ @p first, @p last ) as comma-separated components, e.g. @c "1,-2,3" .
+ * @return Like @c std::to_chars, the end of written text, or @c std::errc::value_too_large if out of space.
+ */
+template <bool Vec, class IntT, std::size_t N>
+std::to_chars_result toChars(char* first, char* last, const ArrNi<Vec, IntT, N>& operand) {
+  for (std::size_t i = 0; i < N; ++i) {
+    if (i != 0) {
+      if (first == last) {
+        return {last, std::errc::value_too_large};
+      }
+      *first++ = ',';
+    }
+    std::to_chars_result ret = std::to_chars(first, last, operand.arr[i]);
+    if (ret.ec != std::errc()) {
+      return ret;
+    }
+    first = ret.ptr;
+  }
+  return {first, std::errc()};
+}
+
+/**
+ * @brief Reads @p operand from [ @p first, @p last ).
+ *
+ * Accepts the output of @ref toChars and of the @c fmt formatter, i.e. components separated by commas and/or spaces,
+ * optionally enclosed in parentheses, each with an optional leading @c '+' or @c '-' sign.
+ * @return Like @c std::from_chars, the end of parsed text and an error code.
+ */
+template <bool Vec, class IntT, std::size_t N>
+std::from_chars_result fromChars(const char* first, const char* last, ArrNi<Vec, IntT, N>& operand) {
+  const char* p = first;
+  auto skip = [&p, last](bool allowComma) {
+    while (p != last && (*p == ' ' || *p == '\t' || (allowComma && *p == ','))) {
+      ++p;
+    }
+  };
+  skip(false);
+  bool parenthesized = p != last && *p == '(';
+  p += parenthesized;
+  ArrNi<Vec, IntT, N> ret;
+  for (std::size_t i = 0; i < N; ++i) {
+    skip(i != 0);
+    std::from_chars_result result = internal::parseInteger(p, last, ret.arr[i]);
+    if (result.ec != std::errc()) {
+      return {first, result.ec};
+    }
+    p = result.ptr;
+  }
+  if (parenthesized) {
+    skip(false);
+    if (p == last || *p != ')') {
+      return {first, std::errc::invalid_argument};
+    }
+    ++p;
+  }
+  operand = ret;
+  return {p, std::errc()};
+}
+
+/**
+ * @brief Parses all arrays in @p text and appends them to @p output .
+ *
+ * Integers may be separated by any mix of spaces, tabs, newlines, commas, semicolons and parentheses,
+ * and every @c ArrT::dimension consecutive integers form an array, so dumps from @ref toChars or @c fmt
+ * can be read back in bulk. Short integers are converted 8 digits at a time.
+ * @return The count of arrays appended.
+ */
+template <class ArrT>
+std::size_t parseArrays(string_view text, std::vector<ArrT>& output) {
+  using IntT = typename ArrT::valueType;
+  const char* p = text.data();
+  const char* last = p + text.size();
+  const std::size_t oldSize = output.size();
+  ArrT current{};
+  std::size_t component = 0;
+  while (true) {
+    while (p != last && internal::isSeparator(*p)) {
+      ++p;
+    }
+    if (p == last) {
+      break;
+    }
+    IntT value{};
+    std::from_chars_result ret = internal::parseInteger(p, last, value);
+    COMMON613_REQUIRE(ret.ec == std::errc(), "Failed to parse integer at offset {}.", p - text.data());
+    COMMON613_REQUIRE(ret.ptr == last || internal::isSeparator(*ret.ptr), "Unexpected character at offset {}.",
+                      ret.ptr - text.data());
+    p = ret.ptr;
+    current.arr[component++] = value;
+    if (component == ArrT::dimension) {
+      output.push_back(current);
+      component = 0;
+    }
+  }
+  COMMON613_REQUIRE(component == 0, "Incomplete array at the end: {} of {} components.", component, ArrT::dimension);
+  return output.size() - oldSize;
+}
+
+}
+
+namespace fmt {
+
+/**
+ * @brief Formats @ref common613::ArrNi like @c "(1, -2, 3)" .
+ *
+ * Format specifications apply to each component, e.g. @c "{:+}" gives @c "(+1, -2, +3)" .
+ */
+template <bool Vec, class IntT, std::size_t N, class Char>
+struct formatter<common613::ArrNi<Vec, IntT, N>, Char> : formatter<IntT, Char> {
+  template <class FormatContext>
+  auto format(const common613::ArrNi<Vec, IntT, N>& operand, FormatContext& ctx) const -> decltype(ctx.out()) {
+    auto out = ctx.out();
+    *out++ = Char('(');
+    for (std::size_t i = 0; i < N; ++i) {
+      if (i != 0) {
+        *out++ = Char(',');
+        *out++ = Char(' ');
+      }
+      ctx.advance_to(out);
+      out = formatter<IntT, Char>::format(operand.arr[i], ctx);
+    }
+    *out++ = Char(')');
+    return out;
+  }
+};
+
+}
+
+#endif //COMMON613_VECTOR_FORMAT_H
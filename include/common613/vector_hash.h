@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+/// @file
+/// @brief Hashing for integer vectors, with @c std::hash specializations.
+
+#pragma once
+#ifndef COMMON613_VECTOR_HASH_H
+#define COMMON613_VECTOR_HASH_H
+
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <common613/compat/cpp17.h>
+#include <common613/vector_arith_utils.h>
+#include <common613/vector_definitions.h>
+
+namespace common613 {
+
+/// @cond
+namespace internal {
+
+// One multiply-xorshift round. Bijective, and moves the well-mixed high bits down to the low bits used by tables.
+COMMON613_NODISCARD
+constexpr std::uint64_t mixHash(std::uint64_t word) {
+  word *= 0x9E3779B97F4A7C15ULL;
+  return word ^ (word >> 32);
+}
+
+}
+/// @endcond
+
+/**
+ * @brief Hashes the components of @p operand .
+ *
+ * Components are packed into 64-bit words as raw bits, and each word costs one multiply-xorshift round,
+ * so points of at most 8 bytes (e.g. @c Arr2i<int32_t> ) are hashed with a single multiplication.
+ * The result is well-mixed in all bits, and is suitable for power-of-two sized tables.
+ */
+template <bool Vec, class IntT, std::size_t N>
+COMMON613_NODISCARD
+constexpr std::size_t hashValue(const ArrNi<Vec, IntT, N>& operand) {
+  static_assert(std::is_integral<IntT>::value && sizeof(IntT) <= 8, "Only integers up to 64 bits are hashable.");
+  using Lane = std::make_unsigned_t<IntT>;
+  constexpr std::size_t lanesPerWord = 8 / sizeof(IntT);
+  std::uint64_t hash = 0, word = 0;
+  for (std::size_t i = 0; i < N; ++i) {
+    word |= std::uint64_t(static_cast<Lane>(operand.arr[i])) << (i % lanesPerWord * sizeof(IntT) * 8);
+    if ((i + 1) % lanesPerWord == 0 || i + 1 == N) {
+      hash = internal::mixHash(hash ^ word);
+      word = 0;
+    }
+  }
+  return static_cast<std::size_t>(hash);
+}
+
+/**
+ * @brief Hashes @p count items from @p operands into @p hashes , like calling @ref hashValue on each.
+ * @note Independent iterations allow the multiplications to be pipelined or vectorized.
+ */
+template <bool Vec, class IntT, std::size_t N>
+inline void hashValues(const ArrNi<Vec, IntT, N>* operands, std::size_t count, std::size_t* hashes) {
+  for (std::size_t i = 0; i < count; ++i) {
+    hashes[i] = hashValue(operands[i]);
+  }
+}
+
+}
+
+namespace std {
+
+/// @brief @c std::hash specialization for @ref common613::ArrNi , calling @ref common613::hashValue .
+template <bool Vec, class IntT, std::size_t N>
+struct hash<common613::ArrNi<Vec, IntT, N>> {
+  std::size_t operator()(const common613::ArrNi<Vec, IntT, N>& operand) const noexcept {
+    return common613::hashValue(operand);
+  }
+};
+
+}
+
+#endif //COMMON613_VECTOR_HASH_H
@@ -0,0 +1,227 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+/// @file
+/// @brief Compile-time neighborhood offset tables, and stencil application over row-major grids.
+
+#pragma once
+#ifndef COMMON613_VECTOR_STENCIL_H
+#define COMMON613_VECTOR_STENCIL_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <common613/compat/cpp17.h>
+#include <common613/vector_box.h>
+#include <common613/vector_definitions.h>
+
+namespace common613 {
+
+/// @brief Shapes of neighborhoods generated by @ref neighborhood.
+enum class Neighborhood {
+  /// @brief Offsets within Manhattan distance, e.g. 4 neighbors in 2-D and 6 in 3-D for radius 1.
+  vonNeumann,
+  /// @brief Offsets within Chebyshev distance, e.g. 8 neighbors in 2-D and 26 in 3-D for radius 1.
+  moore,
+};
+
+/// @cond
+namespace internal {
+
+constexpr std::size_t power(std::size_t base, std::size_t exponent) {
+  std::size_t ret = 1;
+  for (std::size_t i = 0; i < exponent; ++i) {
+    ret *= base;
+  }
+  return ret;
+}
+
+// Decodes cell of the (2 * Radius + 1)^N cube into an offset, and checks whether it belongs to the neighborhood.
+template <Neighborhood Kind, std::size_t N, std::size_t Radius>
+constexpr bool stencilCell(std::size_t cell, std::ptrdiff_t* offset) {
+  std::size_t norm = 0;
+  for (std::size_t d = 0; d < N; ++d) {
+    auto component = static_cast<std::ptrdiff_t>(cell % (2 * Radius + 1)) - static_cast<std::ptrdiff_t>(Radius);
+    cell /= 2 * Radius + 1;
+    offset[d] = component;
+    auto magnitude = static_cast<std::size_t>(component < 0 ? -component : component);
+    norm = Kind == Neighborhood::vonNeumann ? norm + magnitude : std::max(norm, magnitude);
+  }
+  return norm != 0 && norm <= Radius;
+}
+
+template <Neighborhood Kind, std::size_t N, std::size_t Radius>
+constexpr std::size_t stencilSize() {
+  std::ptrdiff_t offset[N]{};
+  std::size_t ret = 0;
+  for (std::size_t cell = 0; cell < power(2 * Radius + 1, N); ++cell) {
+    ret += stencilCell<Kind, N, Radius>(cell, offset);
+  }
+  return ret;
+}
+
+}
+/// @endcond
+
+/**
+ * @brief Generates the offsets of a neighborhood at compile time, excluding the zero offset.
+ *
+ * Offsets are ordered with component 0 varying fastest, e.g. @c neighborhood<Neighborhood::vonNeumann, int, 2>()
+ * gives @c {(0,-1),(-1,0),(1,0),(0,1)} .
+ * @tparam Kind Shape of the neighborhood.
+ * @tparam Radius Maximum distance of offsets.
+ */
+template <Neighborhood Kind, class IntT, std::size_t N, std::size_t Radius = 1>
+COMMON613_NODISCARD
+constexpr std::array<ArrNi<true, IntT, N>, internal::stencilSize<Kind, N, Radius>()> neighborhood() {
+  std::array<ArrNi<true, IntT, N>, internal::stencilSize<Kind, N, Radius>()> ret{};
+  std::ptrdiff_t offset[N]{};
+  std::size_t count = 0;
+  for (std::size_t cell = 0; cell < internal::power(2 * Radius + 1, N); ++cell) {
+    if (internal::stencilCell<Kind, N, Radius>(cell, offset)) {
+      for (std::size_t d = 0; d < N; ++d) {
+        ret[count].arr[d] = static_cast<IntT>(offset[d]);
+      }
+      ++count;
+    }
+  }
+  return ret;
+}
+
+/// @brief Offsets of the von Neumann neighborhood of @p Radius, see @ref neighborhood.
+template <class IntT, std::size_t N, std::size_t Radius = 1>
+COMMON613_NODISCARD constexpr auto vonNeumannOffsets() {
+  return neighborhood<Neighborhood::vonNeumann, IntT, N, Radius>();
+}
+
+/// @brief Offsets of the Moore neighborhood of @p Radius, see @ref neighborhood.
+template <class IntT, std::size_t N, std::size_t Radius = 1>
+COMMON613_NODISCARD constexpr auto mooreOffsets() {
+  return neighborhood<Neighborhood::moore, IntT, N, Radius>();
+}
+
+/**
+ * @brief Converts @p offsets into offsets of indices in a row-major grid of @p shape .
+ *
+ * Component 0 varies fastest in the grid, i.e. the index of @c (x,y,z) is @c x+shape.x()*(y+shape.y()*z) .
+ */
+template <class IntT, std::size_t N, std::size_t K>
+COMMON613_NODISCARD constexpr std::array<std::ptrdiff_t, K> linearOffsets(
+    const ArrNi<true, IntT, N>& shape, const std::array<ArrNi<true, IntT, N>, K>& offsets) {
+  std::array<std::ptrdiff_t, K> ret{};
+  for (std::size_t k = 0; k < K; ++k) {
+    std::ptrdiff_t stride = 1;
+    for (std::size_t d = 0; d < N; ++d) {
+      ret[k] += static_cast<std::ptrdiff_t>(offsets[k].arr[d]) * stride;
+      stride *= static_cast<std::ptrdiff_t>(shape.arr[d]);
+    }
+  }
+  return ret;
+}
+
+/// @cond
+namespace internal {
+
+template <class T, std::size_t K, std::size_t... IND>
+std::array<T, K> gatherInterior(const T* center, const std::array<std::ptrdiff_t, K>& linear,
+                                std::index_sequence<IND...>) {
+  return {center[linear[IND]]...};
+}
+
+template <class IntT, std::size_t N, std::size_t K, class T>
+std::array<T, K> gatherBorder(const ArrNi<true, IntT, N>& shape, const std::array<ArrNi<true, IntT, N>, K>& offsets,
+                              const std::array<std::ptrdiff_t, K>& linear, const ArrNi<false, IntT, N>& position,
+                              const T* center, const T& border) {
+  std::array<T, K> ret;
+  for (std::size_t k = 0; k < K; ++k) {
+    bool inside = true;
+    for (std::size_t d = 0; d < N; ++d) {
+      inside &= inRange(static_cast<IntT>(position.arr[d] + offsets[k].arr[d]), IntT{0}, shape.arr[d]);
+    }
+    ret[k] = inside ? center[linear[k]] : border;
+  }
+  return ret;
+}
+
+}
+/// @endcond
+
+/**
+ * @brief Computes @c output[i]=op(input[i],neighbors) for every cell of a row-major grid of @p shape .
+ *
+ * @c neighbors is a @c std::array<T,K> of the cells at @p offsets in order, where cells outside the grid read
+ * @p border . See @ref linearOffsets for the layout.
+ *
+ * Linear offsets are computed once. Only cells within reach of the borders check coordinates,
+ * so the loop over the interior of each row only loads at fixed distances and can be vectorized by the compiler.
+ * @note @p output must not overlap @p input .
+ */
+template <class IntT, std::size_t N, std::size_t K, class T, class U, class Op>
+void applyStencil(const ArrNi<true, IntT, N>& shape, const std::array<ArrNi<true, IntT, N>, K>& offsets,
+                  const T* input, U* output, const T& border, Op op) {
+  for (std::size_t d = 0; d < N; ++d) {
+    if (shape.arr[d] <= 0) {
+      return;
+    }
+  }
+  const std::array<std::ptrdiff_t, K> linear = linearOffsets(shape, offsets);
+  // Reach of offsets below and above along each dimension.
+  ArrNi<true, IntT, N> below{}, above{};
+  for (std::size_t k = 0; k < K; ++k) {
+    for (std::size_t d = 0; d < N; ++d) {
+      below.arr[d] = std::max(below.arr[d], static_cast<IntT>(-offsets[k].arr[d]));
+      above.arr[d] = std::max(above.arr[d], offsets[k].arr[d]);
+    }
+  }
+  const std::ptrdiff_t width = shape.arr[0];
+  const std::ptrdiff_t interiorBegin = std::min<std::ptrdiff_t>(below.arr[0], width);
+  const std::ptrdiff_t interiorEnd = std::max<std::ptrdiff_t>(interiorBegin, width - above.arr[0]);
+
+  ArrNi<false, IntT, N> position{};
+  std::ptrdiff_t rowBase = 0;
+  while (true) {
+    bool interiorRow = true;
+    for (std::size_t d = 1; d < N; ++d) {
+      interiorRow &= position.arr[d] >= below.arr[d] && position.arr[d] < shape.arr[d] - above.arr[d];
+    }
+    const T* in = input + rowBase;
+    U* out = output + rowBase;
+    auto borderCell = [&](std::ptrdiff_t x) {
+      position.arr[0] = static_cast<IntT>(x);
+      out[x] = op(in[x], internal::gatherBorder(shape, offsets, linear, position, in + x, border));
+    };
+    if (interiorRow) {
+      for (std::ptrdiff_t x = 0; x < interiorBegin; ++x) {
+        borderCell(x);
+      }
+      for (std::ptrdiff_t x = interiorBegin; x < interiorEnd; ++x) {
+        out[x] = op(in[x], internal::gatherInterior(in + x, linear, std::make_index_sequence<K>{}));
+      }
+      for (std::ptrdiff_t x = interiorEnd; x < width; ++x) {
+        borderCell(x);
+      }
+    } else {
+      for (std::ptrdiff_t x = 0; x < width; ++x) {
+        borderCell(x);
+      }
+    }
+    rowBase += width;
+    // Advances to the next row, carrying into higher dimensions.
+    std::size_t d = 1;
+    for (; d < N; ++d) {
+      if (++position.arr[d] < shape.arr[d]) {
+        break;
+      }
+      position.arr[d] = 0;
+    }
+    if (d >= N) {
+      return;
+    }
+  }
+}
+
+}
+
+#endif //COMMON613_VECTOR_STENCIL_H
@@ -15,3 +15,30 @@ TEST(Assertions, Success) {
 TEST(Assertions, Failure) {
   ASSERT_ANY_THROW(COMMON613_REQUIRE(false, "should die here {}", "abc"));
 }
+
+#if defined(COMMON613_LIGHT_ASSERT) && COMMON613_LIGHT_ASSERT == 1
+namespace {
+std::string lastMessage;
+}
+
+TEST(Assertions, Sink) {
+  common613::FatalSink previous = common613::setFatalSink([](const std::string& message) { lastMessage = message; });
+  ASSERT_ANY_THROW(COMMON613_REQUIRE(1 + 1 == 3, "math is {}", "broken"));
+  EXPECT_NE(lastMessage.find("(1 + 1 == 3) math is broken"), std::string::npos);
+  common613::setFatalSink(previous);
+  ASSERT_ANY_THROW(COMMON613_FATAL("back to stderr"));
+  EXPECT_EQ(lastMessage.find("back to stderr"), std::string::npos);
+}
+
+TEST(Assertions, DebugSink) {
+  lastMessage.clear();
+  common613::FatalSink previousFatal = common613::setFatalSink([](const std::string& message) { lastMessage = message; });
+  common613::DebugSink previousDebug = common613::setDebugSink([](const std::string& message) {
+    lastMessage = "debug: " + message;
+  });
+  COMMON613_LOG_DEBUG(std::string("trace"));
+  EXPECT_EQ(lastMessage, "debug: trace");
+  common613::setDebugSink(previousDebug);
+  common613::setFatalSink(previousFatal);
+}
+#endif
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <common613/atomic_writer.h>
+
+using namespace std;
+using namespace common613::file;
+using common613::filesystem::path;
+
+class AtomicWriterTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    directory = common613::filesystem::temp_directory_path() /
+        ("common613_atomic_" + string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+    common613::filesystem::create_directories(directory);
+    target = directory / "snapshot.bin";
+  }
+
+  void TearDown() override {
+    common613::filesystem::remove_all(directory);
+  }
+
+  size_t fileCount() const {
+    size_t count = 0;
+    for (const auto& item : common613::filesystem::directory_iterator(directory)) {
+      (void) item;
+      ++count;
+    }
+    return count;
+  }
+
+  static string readString(const path& filePath) {
+    File file = open(filePath, "rb");
+    common613::Memory memory = readAll(file);
+    return string(memory.begin(), memory.end());
+  }
+
+  path directory;
+  path target;
+};
+
+TEST_F(AtomicWriterTest, commit) {
+  {
+    AtomicWriter writer(target);
+    writer.write("12345", 5);
+    EXPECT_FALSE(common613::filesystem::exists(target));
+    writer.commit();
+    EXPECT_EQ(writer.size(), 5);
+    EXPECT_ANY_THROW(writer.commit());
+  }
+  EXPECT_EQ(readString(target), "12345");
+  EXPECT_EQ(fileCount(), 1);
+}
+
+TEST_F(AtomicWriterTest, discard) {
+  {
+    AtomicWriter writer(target);
+    writer.write("old", 3);
+    writer.commit();
+  }
+  {
+    AtomicWriter writer(target);
+    writer.write("new content", 11);
+  }
+  EXPECT_EQ(readString(target), "old");
+  EXPECT_EQ(fileCount(), 1);
+}
+
+TEST_F(AtomicWriterTest, preallocateAndSync) {
+  AtomicWriteOptions options;
+  options.preallocate = 1 << 20;
+  options.syncInterval = 4096;
+  vector<int> data(10000);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<int>(i);
+  }
+  {
+    AtomicWriter writer(target, options);
+    for (size_t i = 0; i < data.size(); i += 1000) {
+      writer.write(data.data() + i, 1000);
+    }
+    writer.commit();
+  }
+  EXPECT_EQ(common613::filesystem::file_size(target), data.size() * sizeof(int));
+  File file = open(target, "rb");
+  vector<int> loaded(data.size());
+  read(file, loaded.data(), loaded.size());
+  EXPECT_EQ(loaded, data);
+}
+
+#ifdef __linux__
+TEST_F(AtomicWriterTest, failedPreallocation) {
+  AtomicWriteOptions options;
+  // Beyond any file size limit, so fallocate fails with EFBIG or ENOSPC where it is supported.
+  options.preallocate = static_cast<size_t>(1) << 62;
+  try {
+    AtomicWriter writer(target, options);
+    GTEST_SKIP() << "Preallocation is not supported here.";
+  } catch (const std::exception&) {
+  }
+  EXPECT_EQ(fileCount(), 0u);
+}
+#endif
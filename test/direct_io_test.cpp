@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <common613/direct_io.h>
+
+using namespace std;
+using namespace common613::file;
+using common613::filesystem::path;
+
+class DirectIoTest : public ::testing::TestWithParam<CacheMode> {
+protected:
+  void SetUp() override {
+    // Names of parameterized tests are like "roundTrip/2", ending with the index of the mode.
+    string name = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    replace(name.begin(), name.end(), '/', '_');
+    target = common613::filesystem::temp_directory_path() / ("common613_direct_" + name + ".bin");
+  }
+
+  void TearDown() override {
+    common613::filesystem::remove(target);
+  }
+
+  path target;
+};
+
+TEST_P(DirectIoTest, roundTrip) {
+  for (size_t size : {0, 1, 4095, 4096, 5000, 8192 * 3, 8192 * 3 + 17}) {
+    vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; ++i) {
+      data[i] = static_cast<uint8_t>(i * 131 + size);
+    }
+    {
+      UncachedFile file(target, Access::write, GetParam(), 8192);
+      EXPECT_TRUE(file.mode() == GetParam() || file.mode() == CacheMode::dontCache);
+      // Unaligned pieces across block boundaries.
+      size_t half = size / 3;
+      file.write(data.data(), half);
+      file.write(data.data() + half, size - half);
+      file.close();
+    }
+    ASSERT_EQ(common613::filesystem::file_size(target), size);
+    common613::Memory loaded = readAll(target, GetParam());
+    ASSERT_EQ(loaded.size(), size);
+    EXPECT_TRUE(equal(loaded.begin(), loaded.end(), data.begin()));
+  }
+}
+
+TEST_P(DirectIoTest, typedReads) {
+  vector<uint32_t> values(10000);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<uint32_t>(i * i);
+  }
+  writeAll(target, values.data(), values.size(), GetParam());
+
+  UncachedFile file(target, Access::read, GetParam(), 4096);
+  uint32_t first[3];
+  file.read(first, 3);
+  EXPECT_EQ(first[2], 4u);
+  vector<uint32_t> rest(values.size() - 3);
+  file.read(rest.data(), rest.size());
+  EXPECT_EQ(rest.back(), values.back());
+  EXPECT_ANY_THROW(file.read(first));
+  EXPECT_ANY_THROW(file.write(first));
+}
+
+#ifdef __linux__
+TEST_P(DirectIoTest, closeAfterFailure) {
+  auto countFds = [] {
+    size_t count = 0;
+    for (auto it = common613::filesystem::directory_iterator("/proc/self/fd");
+         it != common613::filesystem::directory_iterator(); ++it) {
+      ++count;
+    }
+    return count;
+  };
+  size_t before = countFds();
+  {
+    // Writes to /dev/full fail with ENOSPC.
+    UncachedFile file("/dev/full", Access::write, GetParam(), 4096);
+    char buffer[] = "123456789";
+    file.write(&buffer);
+    EXPECT_ANY_THROW(file.close());
+    EXPECT_EQ(countFds(), before);
+    EXPECT_NO_THROW(file.close());
+  }
+  EXPECT_EQ(countFds(), before);
+}
+#endif
+
+INSTANTIATE_TEST_SUITE_P(Modes, DirectIoTest,
+                         ::testing::Values(CacheMode::normal, CacheMode::dontCache, CacheMode::direct));
+
+TEST(DirectIoDropCacheTest, file) {
+  File file(std::tmpfile());
+  char buffer[] = "123456789";
+  write(file, &buffer);
+  ASSERT_NO_THROW(dropCache(file));
+  seek(file, 0, SEEK_SET);
+  EXPECT_EQ(readAll(file).size(), sizeof(buffer));
+}
@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+#include <string>
+#include <gtest/gtest.h>
+#include <common613/directory_loader.h>
+
+using namespace std;
+using namespace common613::file;
+using common613::filesystem::path;
+
+class DirectoryLoaderTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    root = common613::filesystem::temp_directory_path() / ("common613_loader_" + to_string(::testing::UnitTest::GetInstance()->random_seed()) + "_" + ::testing::UnitTest::GetInstance()->current_test_info()->name());
+    common613::filesystem::create_directories(root / "sub");
+    for (int i = 0; i < 50; ++i) {
+      writeFile(root / ("file" + to_string(i) + ".txt"), string(i, static_cast<char>('a' + i % 26)));
+    }
+    writeFile(root / "skip.bin", "binary");
+    writeFile(root / "sub" / "nested.txt", "nested");
+  }
+
+  void TearDown() override {
+    common613::filesystem::remove_all(root);
+  }
+
+  static void writeFile(const path& filePath, const string& content) {
+    File file = open(filePath, "wb");
+    write(file, content.data(), content.size());
+  }
+
+  static string contentOf(const LoadedDirectory& loaded, size_t index) {
+    return string(reinterpret_cast<const char*>(loaded.content(index)), loaded.files[index].size);
+  }
+
+  path root;
+};
+
+TEST_F(DirectoryLoaderTest, flat) {
+  LoadedDirectory loaded = loadDirectory(root);
+  ASSERT_EQ(loaded.files.size(), 51);
+  size_t total = 0;
+  for (size_t i = 0; i < loaded.files.size(); ++i) {
+    EXPECT_EQ(loaded.files[i].offset, total);
+    total += loaded.files[i].size;
+    string name = loaded.files[i].path.filename().string();
+    if (name == "skip.bin") {
+      EXPECT_EQ(contentOf(loaded, i), "binary");
+    } else {
+      int n = stoi(name.substr(4));
+      EXPECT_EQ(contentOf(loaded, i), string(n, static_cast<char>('a' + n % 26)));
+    }
+  }
+  EXPECT_EQ(loaded.data.size(), total);
+}
+
+TEST_F(DirectoryLoaderTest, filteredRecursive) {
+  common613::ThreadPool pool(2);
+  DirectoryLoadOptions options;
+  options.recursive = true;
+  options.filter = [](const path& filePath) { return filePath.extension() == ".txt"; };
+  options.pool = &pool;
+  options.grain = 3;
+  LoadedDirectory loaded = loadDirectory(root, options);
+  ASSERT_EQ(loaded.files.size(), 51);
+  bool nestedFound = false;
+  for (size_t i = 0; i < loaded.files.size(); ++i) {
+    EXPECT_EQ(loaded.files[i].path.extension(), ".txt");
+    if (loaded.files[i].path.filename() == "nested.txt") {
+      nestedFound = true;
+      EXPECT_EQ(contentOf(loaded, i), "nested");
+    }
+  }
+  EXPECT_TRUE(nestedFound);
+}
+
+TEST_F(DirectoryLoaderTest, missing) {
+  EXPECT_ANY_THROW((void) loadDirectory(root / "missing"));
+}
@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <common613/endian.h>
+#include <common613/vector_arith_utils.h>
+
+using namespace std;
+using common613::ArrNi;
+using common613::Endian;
+using common613::byteSwap;
+using common613::swapEndian;
+
+namespace {
+
+struct Header {
+  uint32_t magic;
+  uint16_t version;
+  char tag[2];
+  ArrNi<false, int32_t, 2> origin;
+  COMMON613_INJECT_SIZE_FIELD(16);
+};
+COMMON613_CHECK_BINARY_USABLE(Header);
+
+struct Record {
+  int64_t id;
+  int16_t values[3];
+  uint8_t flag;
+  uint8_t padding;
+  uint32_t count;
+  uint32_t reserved;
+  COMMON613_INJECT_SIZE_FIELD(24);
+};
+COMMON613_CHECK_BINARY_USABLE(Record);
+
+}
+
+namespace common613 {
+
+template <>
+struct EndianLayout<Header> : EndianFields<COMMON613_ENDIAN_FIELD(Header, magic),
+                                           COMMON613_ENDIAN_FIELD(Header, version),
+                                           COMMON613_ENDIAN_FIELD(Header, origin)> {};
+
+template <>
+struct EndianLayout<Record> : EndianFields<COMMON613_ENDIAN_FIELD(Record, id),
+                                           COMMON613_ENDIAN_FIELD(Record, values),
+                                           COMMON613_ENDIAN_FIELD(Record, count)> {};
+
+}
+
+TEST(EndianTest, byteSwap) {
+  static_assert(byteSwap<uint32_t>(0x12345678U) == 0x78563412U, "constexpr byteSwap");
+  EXPECT_EQ(byteSwap<uint16_t>(0x1234), 0x3412);
+  EXPECT_EQ(byteSwap<int64_t>(0x0102030405060708LL), 0x0807060504030201LL);
+  EXPECT_EQ(byteSwap<int8_t>(-3), -3);
+}
+
+TEST(EndianTest, structs) {
+  Header header{0x11223344U, 0x5566, {'a', 'b'}, ArrNi<false, int32_t, 2>{-2, 0x01020304}};
+  swapEndian(&header, 1);
+  EXPECT_EQ(header.magic, 0x44332211U);
+  EXPECT_EQ(header.version, 0x6655);
+  EXPECT_EQ(header.tag[0], 'a');
+  EXPECT_EQ(header.tag[1], 'b');
+  EXPECT_EQ(header.origin.x(), byteSwap<int32_t>(-2));
+  EXPECT_EQ(header.origin.y(), 0x04030201);
+
+  Record record{1, {0x0102, 0x0304, -1}, 7, 9, 0xAABBCCDDU, 0x01020304U};
+  swapEndian(&record, 1);
+  EXPECT_EQ(record.id, 0x0100000000000000LL);
+  EXPECT_EQ(record.values[0], 0x0201);
+  EXPECT_EQ(record.values[1], 0x0403);
+  EXPECT_EQ(record.values[2], -1);
+  EXPECT_EQ(record.flag, 7);
+  EXPECT_EQ(record.padding, 9);
+  EXPECT_EQ(record.count, 0xDDCCBBAAU);
+  EXPECT_EQ(record.reserved, 0x01020304U);
+}
+
+namespace {
+
+template <class T>
+vector<unsigned char> bytesOf(const vector<T>& records) {
+  const auto* first = reinterpret_cast<const unsigned char*>(records.data());
+  return vector<unsigned char>(first, first + records.size() * sizeof(T));
+}
+
+template <class T>
+void checkBulk(size_t count) {
+  mt19937 random(613);
+  vector<T> records(count);
+  auto* bytes = reinterpret_cast<unsigned char*>(records.data());
+  for (size_t i = 0; i < count * sizeof(T); ++i) {
+    bytes[i] = static_cast<unsigned char>(random());
+  }
+  vector<T> expected = records;
+  for (auto& record : expected) {
+    common613::EndianLayout<T>::swap(reinterpret_cast<unsigned char*>(&record));
+  }
+  vector<T> swapped = records;
+  swapEndian(swapped.data(), swapped.size());
+  EXPECT_EQ(bytesOf(swapped), bytesOf(expected));
+  swapEndian(swapped.data(), swapped.size());
+  EXPECT_EQ(bytesOf(swapped), bytesOf(records));
+}
+
+}
+
+TEST(EndianTest, bulk) {
+  for (size_t count : {0, 1, 5, 33, 1000}) {
+    checkBulk<Header>(count);
+    checkBulk<Record>(count);
+    checkBulk<uint16_t>(count);
+    checkBulk<uint64_t>(count);
+    checkBulk<ArrNi<true, int32_t, 2>>(count);
+    checkBulk<ArrNi<true, int16_t, 3>>(count);
+  }
+}
+
+TEST(EndianTest, file) {
+  using namespace common613::file;
+  File file(std::tmpfile());
+  vector<uint32_t> values(100000);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<uint32_t>(i * 2654435761U);
+  }
+  writeAs<Endian::big>(file, values.data(), values.size());
+  writeAs<Endian::little>(file, values.data() + 1);
+
+  // values[1] is 0x9E3779B1, whose bytes all differ, so any reordering is caught.
+  ASSERT_EQ(values[1], 0x9E3779B1U);
+  unsigned char bytes[4];
+  seek(file, 4, SEEK_SET);
+  read(file, bytes, 4);
+  EXPECT_EQ(bytes[0], 0x9E);
+  EXPECT_EQ(bytes[1], 0x37);
+  EXPECT_EQ(bytes[2], 0x79);
+  EXPECT_EQ(bytes[3], 0xB1);
+  seek(file, static_cast<long>(values.size() * 4), SEEK_SET);
+  read(file, bytes, 4);
+  EXPECT_EQ(bytes[0], 0xB1);
+  EXPECT_EQ(bytes[1], 0x79);
+  EXPECT_EQ(bytes[2], 0x37);
+  EXPECT_EQ(bytes[3], 0x9E);
+
+  seek(file, 0, SEEK_SET);
+  vector<uint32_t> loaded(values.size());
+  readAs<Endian::big>(file, loaded.data(), loaded.size());
+  EXPECT_EQ(loaded, values);
+  uint32_t last = 0;
+  readAs<Endian::little>(file, &last);
+  EXPECT_EQ(last, values[1]);
+}
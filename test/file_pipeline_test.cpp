@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#include <gtest/gtest.h>
+#include <common613/file_pipeline.h>
+
+using namespace std;
+using namespace common613::file;
+
+namespace {
+
+File makeFile(size_t count) {
+  File file(std::tmpfile());
+  vector<uint32_t> values(count);
+  iota(values.begin(), values.end(), 1u);
+  write(file, values.data(), values.size());
+  seek(file, 0, SEEK_SET);
+  return file;
+}
+
+}
+
+TEST(FilePipelineTest, orderedSums) {
+  constexpr size_t count = 300000;
+  for (size_t parsers : {1, 2, 4}) {
+    for (size_t blockSize : {4096, 1000 * 4, 1 << 20}) {
+      File file = makeFile(count);
+      PipelineOptions options;
+      options.blockSize = blockSize;
+      options.parsers = parsers;
+      size_t expectedIndex = 0;
+      uint64_t total = 0, bytes = 0;
+      runPipeline(file, [](const unsigned char* data, size_t size, size_t) {
+        const auto* values = reinterpret_cast<const uint32_t*>(data);
+        return make_pair(accumulate(values, values + size / 4, uint64_t{0}), size);
+      }, [&](pair<uint64_t, size_t>&& result, size_t index) {
+        ASSERT_EQ(index, expectedIndex++);
+        total += result.first;
+        bytes += result.second;
+      }, options);
+      EXPECT_EQ(bytes, count * 4);
+      EXPECT_EQ(total, uint64_t{count} * (count + 1) / 2);
+      EXPECT_EQ(expectedIndex, (count * 4 + blockSize - 1) / blockSize);
+    }
+  }
+}
+
+TEST(FilePipelineTest, emptyFile) {
+  File file(std::tmpfile());
+  size_t collected = 0;
+  runPipeline(file, [](const unsigned char*, size_t size, size_t) { return size; },
+              [&](size_t&&, size_t) { ++collected; });
+  EXPECT_EQ(collected, 0u);
+}
+
+TEST(FilePipelineTest, exceptions) {
+  PipelineOptions options;
+  options.blockSize = 4096;
+  options.parsers = 3;
+  File file = makeFile(100000);
+  EXPECT_THROW(runPipeline(file, [](const unsigned char*, size_t, size_t index) {
+    if (index == 20) {
+      throw invalid_argument("parse");
+    }
+    return index;
+  }, [](size_t&&, size_t) {}, options), invalid_argument);
+
+  File another = makeFile(100000);
+  EXPECT_THROW(runPipeline(another, [](const unsigned char*, size_t, size_t index) { return index; },
+                           [](size_t&&, size_t index) {
+                             if (index == 5) {
+                               throw out_of_range("collect");
+                             }
+                           }, options), out_of_range);
+}
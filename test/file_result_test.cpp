@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+#include <cerrno>
+#include <gtest/gtest.h>
+#include <common613/file_result.h>
+
+using namespace std;
+using namespace common613::file;
+using common613::filesystem::path;
+
+namespace {
+
+string temporaryName() {
+  return (common613::filesystem::temp_directory_path() /
+      ("common613_result_" + string(::testing::UnitTest::GetInstance()->current_test_info()->name()))).string();
+}
+
+}
+
+TEST(FileResultTest, open) {
+  string filename = temporaryName();
+  Result<File> missing = tryOpen(filename, "r");
+  ASSERT_FALSE(missing);
+  EXPECT_EQ(missing.error().operation, Operation::open);
+  EXPECT_EQ(missing.error().code, ENOENT);
+  EXPECT_EQ(missing.error().errorCode(), std::errc::no_such_file_or_directory);
+  EXPECT_STREQ(missing.error().path, filename.c_str());
+  EXPECT_NE(missing.error().message().find(filename), string::npos);
+  EXPECT_ANY_THROW((void) missing.value());
+
+  Result<File> created = tryOpen(filename, "w");
+  ASSERT_TRUE(created.hasValue());
+  EXPECT_NE(*created, nullptr);
+  EXPECT_TRUE(tryOpen(path(filename), "r"));
+  remove(filename.c_str());
+
+  // The path is kept after the temporary argument is gone.
+  Result<File> missingTemporary = tryOpen(path(filename) / "missing", "r");
+  ASSERT_FALSE(missingTemporary);
+  EXPECT_EQ(string(missingTemporary.error().path), (path(filename) / "missing").string());
+  EXPECT_NE(missingTemporary.error().message().find("missing"), string::npos);
+
+  string longName = filename + "/" + string(Error::pathCapacity * 2, 'x');
+  Result<File> missingLong = tryOpen(longName, "r");
+  ASSERT_FALSE(missingLong);
+  string cut = missingLong.error().path;
+  EXPECT_EQ(cut.size(), Error::pathCapacity - 1);
+  EXPECT_EQ(cut.substr(0, cut.size() - 3), longName.substr(0, cut.size() - 3));
+  EXPECT_EQ(cut.substr(cut.size() - 3), "...");
+}
+
+TEST(FileResultTest, readWrite) {
+  File file(std::tmpfile());
+  char buffer[] = "123456789";
+  ASSERT_TRUE(tryWrite(file, buffer, 9));
+  ASSERT_TRUE(trySeek(file, 0, SEEK_SET));
+  char loaded[12] = {'\0'};
+  ASSERT_TRUE(tryRead(file, loaded, 4));
+  EXPECT_STREQ("1234", loaded);
+
+  Result<void> overcount = tryRead(file, loaded, 12);
+  ASSERT_FALSE(overcount);
+  EXPECT_EQ(overcount.error().operation, Operation::read);
+  EXPECT_EQ(overcount.error().code, 0);
+  EXPECT_EQ(overcount.error().done, 5u);
+  EXPECT_EQ(overcount.error().required, 12u);
+  EXPECT_ANY_THROW(overcount.value());
+
+  EXPECT_FALSE(trySeek(file, -100, SEEK_SET));
+  EXPECT_EQ(trySeek(file, -100, SEEK_SET).error().code, EINVAL);
+}
+
+TEST(FileResultTest, readAll) {
+  File file(std::tmpfile());
+  char buffer[] = "123456789";
+  ASSERT_TRUE(tryWrite(file, &buffer));
+  Result<common613::Memory> memory = tryReadAll(file);
+  ASSERT_TRUE(memory);
+  ASSERT_EQ(memory->size(), sizeof(buffer));
+  EXPECT_EQ(memory->front(), '1');
+  EXPECT_EQ(std::move(memory).value().back(), '\0');
+
+  string filename = temporaryName();
+  File writeOnly = open(filename, "w");
+  write(writeOnly, &buffer);
+  Result<common613::Memory> failed = tryReadAll(writeOnly);
+  ASSERT_FALSE(failed);
+  EXPECT_EQ(failed.error().code, EBADF);
+  remove(filename.c_str());
+}
+
+TEST(FileResultTest, alternatives) {
+  struct Token {
+    explicit Token(int id) : id(id) {}
+    int id;
+  };
+
+  Result<Token> token = Token(3);
+  ASSERT_TRUE(token);
+  EXPECT_EQ(token->id, 3);
+  Result<Token> failed = Error{Operation::read, EIO};
+  ASSERT_FALSE(failed);
+  token = failed;
+  ASSERT_FALSE(token);
+  EXPECT_EQ(token.error().code, EIO);
+  token = Result<Token>(Token(4));
+  ASSERT_TRUE(token);
+  EXPECT_EQ(token.value().id, 4);
+}
@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <gtest/gtest.h>
+#include <common613/flat_hash_map.h>
+
+using namespace std;
+using common613::ArrNi;
+using common613::FlatHashMap;
+
+TEST(FlatHashMapTest, basic) {
+  typedef ArrNi<false, int, 2> Point;
+  FlatHashMap<Point, int> map;
+
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.find(Point{1, 2}), map.end());
+
+  EXPECT_TRUE(map.insert({Point{1, 2}, 3}).second);
+  EXPECT_FALSE(map.insert({Point{1, 2}, 4}).second);
+  EXPECT_EQ(map.at(Point{1, 2}), 3);
+  map[Point{2, 1}] = 5;
+  EXPECT_EQ(map.size(), 2);
+  EXPECT_TRUE(map.contains(Point{2, 1}));
+  EXPECT_EQ(map.count(Point{0, 0}), 0);
+  EXPECT_ANY_THROW((void) map.at(Point{0, 0}));
+
+  int sum = 0;
+  for (const auto& entry : map) {
+    sum += entry.second;
+  }
+  EXPECT_EQ(sum, 8);
+
+  EXPECT_EQ(map.erase(Point{1, 2}), 1);
+  EXPECT_EQ(map.erase(Point{1, 2}), 0);
+  EXPECT_EQ(map.size(), 1);
+  EXPECT_EQ(map.find(Point{2, 1})->second, 5);
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.begin(), map.end());
+}
+
+TEST(FlatHashMapTest, existingKeyDoesNotRehash) {
+  typedef ArrNi<false, int, 2> Point;
+  FlatHashMap<Point, int> map(1);
+  for (int i = 0; map.size() < map.capacity() / 4 * 3; ++i) {
+    map[Point{i, 0}] = i;
+  }
+  const size_t capacity = map.capacity();
+  auto it = map.find(Point{0, 0});
+
+  EXPECT_FALSE(map.try_emplace(Point{0, 0}, 7).second);
+  map[Point{1, 0}] = 8;
+  EXPECT_EQ(map.capacity(), capacity);
+  EXPECT_EQ(it, map.find(Point{0, 0}));
+  EXPECT_EQ(it->second, 0);
+
+  map[Point{-1, 0}] = 9;
+  EXPECT_GT(map.capacity(), capacity);
+}
+
+TEST(FlatHashMapTest, randomized) {
+  typedef ArrNi<false, int16_t, 2> Point;
+  FlatHashMap<Point, int> map;
+  unordered_map<Point, int> reference;
+
+  mt19937 random(613);
+  uniform_int_distribution<int> coordinate(-20, 20), operation(0, 2);
+  for (int i = 0; i < 20000; ++i) {
+    Point key = Point::of(coordinate(random), coordinate(random));
+    switch (operation(random)) {
+      case 0:
+        map[key] = i;
+        reference[key] = i;
+        break;
+      case 1:
+        EXPECT_EQ(map.erase(key), reference.erase(key));
+        break;
+      default:
+        auto it = map.find(key);
+        auto refIt = reference.find(key);
+        ASSERT_EQ(it == map.end(), refIt == reference.end());
+        if (refIt != reference.end()) {
+          EXPECT_EQ(it->second, refIt->second);
+        }
+    }
+    ASSERT_EQ(map.size(), reference.size());
+  }
+
+  size_t visited = 0;
+  for (const auto& entry : map) {
+    EXPECT_EQ(reference.at(entry.first), entry.second);
+    ++visited;
+  }
+  EXPECT_EQ(visited, reference.size());
+}
@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <common613/record_reader.h>
+
+using namespace std;
+using namespace common613::file;
+using common613::string_view;
+
+class RecordReaderTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    file.reset(std::tmpfile());
+  }
+
+  void fill(const string& content) {
+    write(file, content.data(), content.size());
+    seek(file, 0, SEEK_SET);
+  }
+
+  vector<string> readRecords(char delimiter, size_t bufferSize) {
+    RecordReader reader(file, delimiter, bufferSize);
+    vector<string> records;
+    string_view record;
+    while (reader.next(record)) {
+      records.emplace_back(record.data(), record.size());
+    }
+    return records;
+  }
+
+  File file;
+};
+
+TEST_F(RecordReaderTest, lines) {
+  fill("first\n\nthird line\nlast");
+  EXPECT_EQ(readRecords('\n', 4096), (vector<string>{"first", "", "third line", "last"}));
+}
+
+TEST_F(RecordReaderTest, trailingDelimiter) {
+  fill("a;bb;ccc;");
+  EXPECT_EQ(readRecords(';', 4096), (vector<string>{"a", "bb", "ccc"}));
+}
+
+TEST_F(RecordReaderTest, empty) {
+  EXPECT_TRUE(readRecords('\n', 16).empty());
+}
+
+TEST_F(RecordReaderTest, straddling) {
+  vector<string> expected;
+  string content;
+  mt19937 random(613);
+  uniform_int_distribution<int> length(0, 100);
+  for (int i = 0; i < 1000; ++i) {
+    expected.emplace_back(length(random), static_cast<char>('a' + i % 26));
+    content += expected.back() + "\n";
+  }
+  fill(content);
+  EXPECT_EQ(readRecords('\n', 7), expected);
+}
+
+TEST(RecordReaderFindTest, findByte) {
+  mt19937 random(613);
+  uniform_int_distribution<int> byte(0, 63);
+  vector<char> data(1000);
+  for (auto& c : data) {
+    c = static_cast<char>(byte(random));
+  }
+  for (size_t first = 0; first < 70; ++first) {
+    for (size_t last = first; last < data.size(); last += 13) {
+      const char* expected = static_cast<const char*>(memchr(data.data() + first, 0, last - first));
+      const char* found = common613::internal::findByte(data.data() + first, data.data() + last, 0);
+      ASSERT_EQ(found, expected == nullptr ? data.data() + last : expected);
+    }
+  }
+}
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <common613/ring_queue.h>
+
+using namespace std;
+using common613::MpmcQueue;
+using common613::SpscQueue;
+
+TEST(RingQueueTest, spscBasics) {
+  SpscQueue<unique_ptr<int>> queue(3);
+  ASSERT_EQ(queue.capacity(), 4u);
+  unique_ptr<int> value;
+  EXPECT_FALSE(queue.tryPop(value));
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(queue.tryPush(make_unique<int>(i)));
+  }
+  auto rejected = make_unique<int>(4);
+  EXPECT_FALSE(queue.tryPush(std::move(rejected)));
+  EXPECT_NE(rejected, nullptr);
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(queue.tryPop(value));
+    EXPECT_EQ(*value, i);
+  }
+  EXPECT_FALSE(queue.tryPop(value));
+}
+
+TEST(RingQueueTest, mpmcBasics) {
+  MpmcQueue<int> queue(5);
+  ASSERT_EQ(queue.capacity(), 8u);
+  int value = 0;
+  EXPECT_FALSE(queue.tryPop(value));
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 8; ++i) {
+      ASSERT_TRUE(queue.tryPush(i + round));
+    }
+    EXPECT_FALSE(queue.tryPush(100));
+    for (int i = 0; i < 8; ++i) {
+      ASSERT_TRUE(queue.tryPop(value));
+      EXPECT_EQ(value, i + round);
+    }
+  }
+}
+
+TEST(RingQueueTest, spscThreads) {
+  constexpr uint64_t count = 1000000;
+  SpscQueue<uint64_t> queue(256);
+  thread producer([&queue] {
+    for (uint64_t i = 0; i < count; ++i) {
+      while (!queue.tryPush(uint64_t{i})) {
+        this_thread::yield();
+      }
+    }
+  });
+  uint64_t expected = 0, value = 0;
+  while (expected < count) {
+    if (queue.tryPop(value)) {
+      ASSERT_EQ(value, expected);
+      ++expected;
+    } else {
+      this_thread::yield();
+    }
+  }
+  producer.join();
+}
+
+TEST(RingQueueTest, mpmcThreads) {
+  constexpr uint64_t perProducer = 200000;
+  constexpr int producers = 4, consumers = 4;
+  MpmcQueue<uint64_t> queue(64);
+  atomic<uint64_t> sum{0}, popped{0};
+  vector<thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&queue] {
+      for (uint64_t i = 1; i <= perProducer; ++i) {
+        while (!queue.tryPush(uint64_t{i})) {
+          this_thread::yield();
+        }
+      }
+    });
+  }
+  for (int c = 0; c < consumers; ++c) {
+    threads.emplace_back([&] {
+      uint64_t value = 0;
+      while (popped.load() < perProducer * producers) {
+        if (queue.tryPop(value)) {
+          sum += value;
+          ++popped;
+        } else {
+          this_thread::yield();
+        }
+      }
+    });
+  }
+  for (thread& t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(popped.load(), perProducer * producers);
+  EXPECT_EQ(sum.load(), perProducer * (perProducer + 1) / 2 * producers);
+}
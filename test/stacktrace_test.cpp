@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <common613/stacktrace.h>
+
+using namespace std;
+using common613::RawStackTrace;
+using common613::TraceSymbolizer;
+
+namespace {
+
+RawStackTrace captureHere() {
+  return RawStackTrace::capture();
+}
+
+}
+
+TEST(StackTraceTest, capture) {
+  RawStackTrace trace = captureHere();
+  ASSERT_FALSE(trace.empty());
+  ASSERT_LE(trace.size(), RawStackTrace::maxDepth);
+  for (size_t i = 0; i < trace.size(); ++i) {
+    EXPECT_NE(trace[i], nullptr);
+  }
+  EXPECT_FALSE(trace.symbolize().empty());
+  string addresses = trace.dumpAddresses();
+  EXPECT_NE(addresses.find(" 0# 0x"), string::npos);
+#ifdef __linux__
+  EXPECT_NE(common613::moduleMap().find("r-x"), string::npos);
+#endif
+}
+
+TEST(StackTraceTest, symbolizer) {
+  mutex lock;
+  vector<string> received;
+  {
+    TraceSymbolizer symbolizer([&](const string& text) {
+      lock_guard<mutex> guard(lock);
+      received.push_back(text);
+    });
+    for (int i = 0; i < 10; ++i) {
+      ASSERT_TRUE(symbolizer.post(captureHere()));
+    }
+    symbolizer.flush();
+    lock_guard<mutex> guard(lock);
+    EXPECT_EQ(received.size(), 10u);
+    EXPECT_EQ(symbolizer.dropped(), 0u);
+  }
+
+  received.clear();
+  {
+    TraceSymbolizer raw([&](const string& text) { received.push_back(text); }, false, 1);
+    size_t posted = 0;
+    for (int i = 0; i < 100; ++i) {
+      posted += raw.post(captureHere());
+    }
+    raw.flush();
+    EXPECT_EQ(posted + raw.dropped(), 100u);
+    // The module map comes first, then one dump per posted trace.
+    ASSERT_EQ(received.size(), posted + 1);
+  }
+  EXPECT_NE(received[1].find(" 0# 0x"), string::npos);
+}
+
+TEST(StackTraceTest, symbolizerRing) {
+  atomic<bool> entered{false};
+  atomic<bool> released{false};
+  size_t received = 0;
+  TraceSymbolizer symbolizer([&](const string&) {
+    entered = true;
+    while (!released) {
+      this_thread::yield();
+    }
+    ++received;
+  }, true, 3);
+  ASSERT_TRUE(symbolizer.post(captureHere()));
+  while (!entered) {
+    this_thread::yield();
+  }
+  // The worker holds the first trace, so the ring of 3 slots fills up, and wraps around after draining.
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(symbolizer.post(captureHere()));
+  }
+  EXPECT_FALSE(symbolizer.post(captureHere()));
+  EXPECT_EQ(symbolizer.dropped(), 1u);
+  released = true;
+  symbolizer.flush();
+  EXPECT_EQ(received, 4u);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(symbolizer.post(captureHere()));
+  }
+  symbolizer.flush();
+  EXPECT_EQ(received, 7u);
+}
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#include <gtest/gtest.h>
+#include <common613/thread_pool.h>
+#include <common613/vector_arith_utils.h>
+
+using namespace std;
+using common613::ArrNi;
+using common613::ThreadPool;
+using common613::parallelFor;
+using common613::parallelReduce;
+using common613::parallelTransform;
+
+TEST(ThreadPoolTest, parallelFor) {
+  ThreadPool pool(4);
+  vector<int> values(100000);
+  parallelFor(pool, 0, values.size(), [&values](size_t i) { values[i] = static_cast<int>(i) * 2; }, 1000);
+  for (size_t i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(values[i], static_cast<int>(i) * 2);
+  }
+}
+
+TEST(ThreadPoolTest, nested) {
+  ThreadPool pool(3);
+  atomic<int> counter{0};
+  parallelFor(pool, 0, 16, [&pool, &counter](size_t) {
+    parallelFor(pool, 0, 100, [&counter](size_t) { ++counter; }, 10);
+  }, 1);
+  EXPECT_EQ(counter.load(), 1600);
+}
+
+TEST(ThreadPoolTest, noWorkers) {
+  ThreadPool pool(0);
+  vector<int> values(1000);
+  parallelFor(pool, 10, 20, [&values](size_t i) { values[i] = 1; }, 3);
+  EXPECT_EQ(accumulate(values.begin(), values.end(), 0), 10);
+}
+
+TEST(ThreadPoolTest, exception) {
+  ThreadPool pool(2);
+  EXPECT_THROW(parallelFor(pool, 0, 1000, [](size_t i) {
+    if (i == 567) {
+      throw runtime_error("expected");
+    }
+  }, 10), runtime_error);
+}
+
+TEST(ThreadPoolTest, transform) {
+  typedef ArrNi<false, int32_t, 2> Point;
+  typedef ArrNi<true, int32_t, 2> Vector;
+
+  vector<Point> points(12345);
+  for (size_t i = 0; i < points.size(); ++i) {
+    points[i] = Point::of(static_cast<int32_t>(i), -static_cast<int32_t>(i));
+  }
+  vector<Point> moved(points.size());
+  const Vector offset{3, 4};
+  parallelTransform(points.data() + 1, points.size() - 1, moved.data() + 1,
+                    [offset](const Point& p) { return p + offset; }, 100);
+  EXPECT_EQ(moved[0], Point{});
+  for (size_t i = 1; i < points.size(); ++i) {
+    ASSERT_EQ(moved[i], points[i] + offset);
+  }
+}
+
+TEST(ThreadPoolTest, reduce) {
+  typedef ArrNi<true, int64_t, 3> Vector;
+
+  vector<Vector> vectors(54321);
+  Vector expected{};
+  for (size_t i = 0; i < vectors.size(); ++i) {
+    vectors[i] = Vector::of(static_cast<int64_t>(i), static_cast<int64_t>(i % 7), -static_cast<int64_t>(i));
+    expected = expected + vectors[i];
+  }
+  ThreadPool pool(4);
+  EXPECT_EQ(parallelReduce(pool, vectors.data(), vectors.size(), Vector{}, std::plus<>{}, 1000), expected);
+  EXPECT_EQ(parallelReduce(pool, vectors.data(), 0, Vector{}, std::plus<>{}), Vector{});
+
+  vector<int> ints(1000, 1);
+  EXPECT_EQ(parallelReduce(ints.data(), ints.size(), 0, std::plus<>{}, 7), 1000);
+
+  // Partials of neighbouring chunks are written concurrently, which must not share bytes even for bool.
+  ints[777] = -1;
+  auto allPositive = [](bool partial, int value) { return partial && value > 0; };
+  EXPECT_FALSE(parallelReduce(pool, ints.data(), ints.size(), true, allPositive, 1));
+  EXPECT_TRUE(parallelReduce(pool, ints.data(), 777, true, allPositive, 1));
+}
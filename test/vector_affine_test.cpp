@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <common613/vector_affine.h>
+
+using namespace std;
+using namespace common613;
+
+TEST(VectorAffineTest, compileTime) {
+  using Affine = Affine2i<int>;
+  using Point = Arr2i<false, int>;
+  constexpr Affine turn = Affine::rotate90(0, 1) * Affine::mirror(1);
+  static_assert(turn(Point::of(1, 2)) == Point::of(2, 1), "mirror, then rotate");
+  static_assert(Affine::rotate90(0, 1, 4) == Affine::identity(), "full turn");
+  static_assert(Affine::rotate90(0, 1, -1) == Affine::rotate90(1, 0), "turning backwards");
+  static_assert(Affine::rotate90(0, 1)(Point::of(1, 0)) == Point::of(0, 1), "x to y");
+  static_assert(turn.isSignedPermutation(), "signed permutation");
+  constexpr Affine shifted = Affine::fromTranslation(Arr2i<true, int>::of(5, -5)) * turn;
+  static_assert(shifted(Point::of(1, 2)) == Point::of(7, -4), "translation after");
+  static_assert(shifted(Arr2i<true, int>::of(1, 2)) == Arr2i<true, int>::of(2, 1), "vectors ignore translation");
+  static_assert(!Affine::fromMatrix({{{2, 1}, {0, 1}}}).isSignedPermutation(), "shear");
+}
+
+TEST(VectorAffineTest, threeDimensions) {
+  using Affine = Affine3i<int64_t>;
+  using Point = Arr3i<false, int64_t>;
+  Affine axes = Affine::fromPermutation({2, 0, 1});
+  EXPECT_EQ(axes(Point::of(1, 2, 3)), Point::of(3, 1, 2));
+  EXPECT_EQ(Affine::rotate90(1, 2, 2)(Point::of(1, 2, 3)), Point::of(1, -2, -3));
+  Affine composed = Affine::fromTranslation(Arr3i<true, int64_t>::of(1, 1, 1)) * axes;
+  EXPECT_EQ((composed * composed)(Point::of(1, 2, 3)), composed(composed(Point::of(1, 2, 3))));
+  EXPECT_ANY_THROW((void) Affine::mirror(3));
+  EXPECT_ANY_THROW((void) Affine::fromPermutation({0, 0, 3}));
+}
+
+namespace {
+
+template <class IntT, size_t N>
+void checkBatch(const AffineNi<IntT, N>& transform) {
+  mt19937 random(613);
+  for (size_t count : {0, 1, 3, 4, 5, 8, 63, 1000}) {
+    vector<ArrNi<false, IntT, N>> points(count);
+    for (auto& point : points) {
+      for (size_t d = 0; d < N; ++d) {
+        point.arr[d] = static_cast<IntT>(static_cast<int>(random() % 20001) - 10000);
+      }
+    }
+    vector<ArrNi<false, IntT, N>> output(count);
+    transformPoints(transform, points.data(), count, output.data());
+    for (size_t i = 0; i < count; ++i) {
+      ASSERT_EQ(output[i], transform(points[i])) << "at " << i;
+    }
+    transformPoints(transform, points.data(), count, points.data());
+    ASSERT_EQ(points, output);
+  }
+}
+
+}
+
+TEST(VectorAffineTest, batch) {
+  using Affine = Affine2i<int32_t>;
+  const auto shift = Affine::fromTranslation(Arr2i<true, int32_t>::of(100, -7));
+  checkBatch(Affine::identity());
+  checkBatch(shift * Affine::mirror(0));
+  checkBatch(shift * Affine::rotate90(0, 1));
+  checkBatch(Affine::rotate90(1, 0) * Affine::mirror(1));
+  checkBatch(shift * Affine::fromMatrix({{{3, -2}, {5, 7}}}));
+  checkBatch(Affine::fromMatrix({{{0, 0}, {1, 0}}}));
+  checkBatch(Affine3i<int32_t>::rotate90(0, 2) * Affine3i<int32_t>::mirror(1));
+  checkBatch(Affine3i<int16_t>::fromMatrix({{{1, 2, 0}, {0, 1, 0}, {0, 0, 1}}}));
+}
+
+TEST(VectorAffineTest, wrapping) {
+  using Affine = Affine2i<int32_t>;
+  using Point = Arr2i<false, int32_t>;
+  const auto shift = Affine::fromTranslation(Arr2i<true, int32_t>::of(INT32_MAX, INT32_MIN));
+  EXPECT_EQ(shift(Point::of(1, -1)), Point::of(INT32_MIN, INT32_MAX));
+  EXPECT_EQ((shift * shift).translation, (Arr2i<true, int32_t>::of(-2, 0)));
+  EXPECT_EQ((shift * shift)(Point::of(1, 2)), shift(shift(Point::of(1, 2))));
+  checkBatch(shift * Affine::fromMatrix({{{1 << 20, 3}, {-70000, 1}}}));
+  checkBatch(Affine2i<int16_t>::fromMatrix({{{300, -200}, {7, 1}}}));
+}
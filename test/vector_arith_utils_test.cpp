@@ -169,3 +169,59 @@ TEST(ArrayArithmeticTest, mixed) {
     EXPECT_EQ(v1 * 2 - v2 * -1 - v3, Vector::of(1, 3));
   }
 }
+
+TEST(ArrayArithmeticTest, packed) {
+  {
+    typedef ArrNi<true, int16_t, 2> Vector;
+    typedef ArrNi<false, int16_t, 2> Point;
+
+    Vector v1{-6, 3}, v2{6, -3}, v3{0, 0}, v4{-12, 6};
+    Point p1{100, -200}, p2{94, -197};
+
+    EXPECT_EQ(v1 + v2, v3);
+    EXPECT_EQ(v1 + v1, v4);
+    EXPECT_EQ(v3 - v1, v2);
+    EXPECT_EQ(v1 - v4, v2);
+    EXPECT_EQ(p1 + v1, p2);
+    EXPECT_EQ(p2 - p1, v1);
+    EXPECT_EQ(p2 - v1, p1);
+    EXPECT_NE(v1, v2);
+
+    EXPECT_EQ(Vector::of(32767, -32768) + Vector::of(-1, 1), Vector::of(32766, -32767));
+    EXPECT_EQ(Vector::of(-32768, 0) - Vector::of(-1, 32767), Vector::of(-32767, -32767));
+    EXPECT_ANY_THROW((void) (Vector::of(32767, 0) + Vector::of(1, 0)));
+    EXPECT_ANY_THROW((void) (Vector::of(0, -32768) + Vector::of(0, -1)));
+    EXPECT_ANY_THROW((void) (Vector::of(0, -32768) - Vector::of(0, 1)));
+  }
+
+  {
+    typedef ArrNi<true, int8_t, 4> Vector;
+
+    Vector v1{-6, 3, 127, -128}, v2{6, -3, -127, 127}, v3{0, 0, 0, -1};
+
+    EXPECT_EQ(v1 + v2, v3);
+    EXPECT_EQ(v3 - v2, v1);
+    EXPECT_EQ(v3 - v1, v2);
+    EXPECT_ANY_THROW((void) (v1 + v1));
+    EXPECT_ANY_THROW((void) (v1 - v2));
+  }
+
+  {
+    typedef ArrNi<true, uint8_t, 4> Vector;
+
+    Vector v1{1, 2, 128, 255}, v2{3, 0, 127, 0}, v3{4, 2, 255, 255};
+
+    EXPECT_EQ(v1 + v2, v3);
+    EXPECT_EQ(v3 - v2, v1);
+    EXPECT_ANY_THROW((void) (v1 + v1));
+    EXPECT_ANY_THROW((void) (v2 - v1));
+  }
+
+  {
+    typedef ArrNi<true, int16_t, 4> Vector;
+
+    constexpr Vector v1{-6, 3, 1000, -1000}, v2{6, -3, 24, 1};
+    static_assert(v1 + v2 == Vector{0, 0, 1024, -999}, "packed arithmetic should be constexpr");
+    EXPECT_EQ(v1 - v2, Vector::of(-12, 6, 976, -1001));
+  }
+}
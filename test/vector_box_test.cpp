@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <common613/vector_box.h>
+
+using namespace std;
+using common613::ArrNi;
+using common613::BoxNi;
+using common613::containingMask;
+using common613::containsMask;
+
+TEST(VectorBoxTest, basic) {
+  typedef BoxNi<int, 2> Box;
+  typedef Box::Point Point;
+  typedef Box::Vector Vector;
+
+  constexpr Box box{Point{1, 2}, Vector{3, 4}};
+  static_assert(box.contains(Point{1, 2}), "origin is inclusive");
+  static_assert(!box.contains(Point{4, 2}), "end is exclusive");
+  static_assert(box.volume() == 12, "volume");
+  static_assert(box.end() == Point{4, 6}, "end");
+
+  EXPECT_TRUE(box.contains(Point{3, 5}));
+  EXPECT_FALSE(box.contains(Point{0, 3}));
+  EXPECT_FALSE(box.contains(Point{2, 6}));
+  EXPECT_EQ(Box::fromCorners(Point{1, 2}, Point{4, 6}), box);
+
+  Box other = Box::fromCorners(Point{3, 0}, Point{10, 3});
+  EXPECT_EQ(box.intersect(other), Box::fromCorners(Point{3, 2}, Point{4, 3}));
+  EXPECT_EQ(box.unite(other), Box::fromCorners(Point{1, 0}, Point{10, 6}));
+  EXPECT_TRUE(box.contains(box.intersect(other)));
+  EXPECT_FALSE(box.contains(other));
+
+  Box far = Box::fromCorners(Point{10, 10}, Point{11, 11});
+  EXPECT_TRUE(box.intersect(far).empty());
+  EXPECT_EQ(box.intersect(far).volume(), 0);
+  EXPECT_EQ(box.unite(box.intersect(far)), box);
+  EXPECT_TRUE(box.contains(box.intersect(far)));
+
+  Box swapped = Box::fromCorners(Point{4, 6}, Point{1, 2});
+  EXPECT_TRUE(swapped.empty());
+  EXPECT_EQ(swapped.extent, Vector{});
+  EXPECT_FALSE(swapped.contains(Point{0, 0}));
+  EXPECT_FALSE(swapped.contains(Point{4, 6}));
+  EXPECT_EQ(Box::fromCorners(Point{1, 6}, Point{4, 2}).extent, (Vector{3, 0}));
+  uint64_t mask = ~0ULL;
+  vector<Point> points{Point{0, 0}, Point{4, 6}, Point{2, 3}, Point{-100, 100}};
+  containsMask(swapped, points.data(), points.size(), &mask);
+  EXPECT_EQ(mask, 0ULL);
+}
+
+TEST(VectorBoxTest, threeDimensions) {
+  typedef BoxNi<int16_t, 3> Box;
+  constexpr Box box{Box::Point{-5, -5, -5}, Box::Vector{10, 10, 10}};
+  EXPECT_EQ(box.volume(), 1000);
+  EXPECT_TRUE(box.contains(Box::Point{-5, 4, 0}));
+  EXPECT_FALSE(box.contains(Box::Point{-5, 5, 0}));
+  EXPECT_FALSE(box.contains(Box::Point{-6, 0, 0}));
+}
+
+namespace {
+
+template <class IntT, size_t N>
+void checkMasks(unsigned seed) {
+  typedef BoxNi<IntT, N> Box;
+  typedef typename Box::Point Point;
+  mt19937 random(seed);
+  uniform_int_distribution<int> coordinate(-20, 20), size(0, 15);
+
+  for (size_t count : {0, 1, 3, 64, 65, 130, 1001}) {
+    vector<Point> points(count);
+    vector<Box> boxes(count);
+    for (size_t i = 0; i < count; ++i) {
+      for (size_t j = 0; j < N; ++j) {
+        points[i].arr[j] = static_cast<IntT>(coordinate(random));
+        boxes[i].origin.arr[j] = static_cast<IntT>(coordinate(random));
+        boxes[i].extent.arr[j] = static_cast<IntT>(size(random));
+      }
+    }
+    const Box box = count == 0 ? Box{} : boxes[0];
+    vector<uint64_t> mask((count + 63) / 64, ~0ULL);
+    containsMask(box, points.data(), count, mask.data());
+    for (size_t i = 0; i < mask.size() * 64; ++i) {
+      bool expected = i < count && box.contains(points[i]);
+      ASSERT_EQ(((mask[i / 64] >> (i % 64)) & 1) != 0, expected) << "point " << i;
+    }
+    fill(mask.begin(), mask.end(), ~0ULL);
+    containingMask(boxes.data(), count, count == 0 ? Point{} : points[0], mask.data());
+    for (size_t i = 0; i < mask.size() * 64; ++i) {
+      bool expected = i < count && boxes[i].contains(points[0]);
+      ASSERT_EQ(((mask[i / 64] >> (i % 64)) & 1) != 0, expected) << "box " << i;
+    }
+  }
+}
+
+}
+
+TEST(VectorBoxTest, masks) {
+  checkMasks<int32_t, 2>(613);
+  checkMasks<int16_t, 2>(614);
+  checkMasks<int64_t, 3>(615);
+}
+
+TEST(VectorBoxTest, extremeMasks) {
+  typedef BoxNi<int32_t, 2> Box;
+  typedef Box::Point Point;
+  Box box{Point{INT32_MIN, -1}, Box::Vector{INT32_MAX, 2}};
+  vector<Point> points{Point{INT32_MIN, 0}, Point{-2, -1}, Point{-1, 0}, Point{INT32_MAX, 0}, Point{0, 1}};
+  uint64_t mask = 0;
+  containsMask(box, points.data(), points.size(), &mask);
+  EXPECT_EQ(mask, 0b00011ULL);
+}
@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <common613/vector_arith_utils.h>
+#include <common613/vector_codec.h>
+
+using namespace std;
+using common613::ArrNi;
+using common613::Memory;
+using common613::decodeDeltas;
+using common613::encodeDeltas;
+
+namespace {
+
+template <class ArrT>
+vector<ArrT> randomWalk(size_t count, int step, unsigned seed) {
+  using IntT = typename ArrT::valueType;
+  mt19937_64 random(seed);
+  uniform_int_distribution<int> delta(-step, step);
+  vector<ArrT> ret(count);
+  for (size_t i = 1; i < count; ++i) {
+    for (size_t j = 0; j < ArrT::dimension; ++j) {
+      ret[i].arr[j] = static_cast<IntT>(ret[i - 1].arr[j] + delta(random));
+    }
+  }
+  return ret;
+}
+
+template <class ArrT>
+vector<ArrT> roundTrip(const vector<ArrT>& input, size_t* encodedSize = nullptr) {
+  Memory encoded;
+  encodeDeltas(input.data(), input.size(), encoded);
+  if (encodedSize != nullptr) {
+    *encodedSize = encoded.size();
+  }
+  vector<ArrT> output(input.size());
+  const unsigned char* end = decodeDeltas(encoded.data(), encoded.data() + encoded.size(), output.data(), output.size());
+  EXPECT_EQ(end, encoded.data() + encoded.size());
+  return output;
+}
+
+}
+
+TEST(VectorCodecTest, smallDeltas) {
+  typedef ArrNi<false, int32_t, 2> Point;
+
+  vector<Point> points = randomWalk<Point>(10001, 100, 613);
+  size_t encodedSize = 0;
+  EXPECT_EQ(roundTrip(points, &encodedSize), points);
+  EXPECT_LT(encodedSize * 3, points.size() * sizeof(Point));
+}
+
+TEST(VectorCodecTest, extremes) {
+  {
+    typedef ArrNi<true, int32_t, 3> Vector;
+    const int32_t lo = numeric_limits<int32_t>::min(), hi = numeric_limits<int32_t>::max();
+    vector<Vector> vectors{Vector{lo, hi, 0}, Vector{hi, lo, -1}, Vector{0, 0, 1}, Vector{lo, lo, lo}, Vector{hi, hi, hi}};
+    EXPECT_EQ(roundTrip(vectors), vectors);
+  }
+  {
+    typedef ArrNi<true, uint8_t, 4> Vector;
+    vector<Vector> vectors{Vector{0, 255, 1, 128}, Vector{255, 0, 254, 127}, Vector{7, 7, 7, 7}};
+    EXPECT_EQ(roundTrip(vectors), vectors);
+  }
+  {
+    typedef ArrNi<false, int64_t, 2> Point;
+    const int64_t lo = numeric_limits<int64_t>::min(), hi = numeric_limits<int64_t>::max();
+    vector<Point> points{Point{lo, hi}, Point{hi, lo}, Point{0, -1}};
+    EXPECT_EQ(roundTrip(points), points);
+    vector<Point> walk = randomWalk<Point>(1000, 1000, 1);
+    EXPECT_EQ(roundTrip(walk), walk);
+  }
+  {
+    typedef ArrNi<false, int16_t, 2> Point;
+    vector<Point> walk = randomWalk<Point>(1003, 30000, 2);
+    EXPECT_EQ(roundTrip(walk), walk);
+    EXPECT_TRUE(roundTrip(vector<Point>{}).empty());
+  }
+}
+
+TEST(VectorCodecTest, truncated) {
+  typedef ArrNi<false, int32_t, 2> Point;
+
+  vector<Point> points = randomWalk<Point>(100, 100000, 3);
+  Memory encoded;
+  encodeDeltas(points.data(), points.size(), encoded);
+  vector<Point> output(points.size());
+  EXPECT_ANY_THROW(decodeDeltas(encoded.data(), encoded.data() + encoded.size() - 1, output.data(), output.size()));
+}
+
+TEST(VectorCodecTest, file) {
+  typedef ArrNi<false, int32_t, 3> Point;
+  using namespace common613::file;
+
+  File file(std::tmpfile());
+  vector<Point> points = randomWalk<Point>(5000, 50, 4);
+  {
+    PointWriter<Point> writer(file, 1000);
+    writer.write(points.data(), 1234);
+    writer.write(points.data() + 1234, points.size() - 1234);
+  }
+  writePoints(file, points.data(), 10);
+  seek(file, 0, SEEK_SET);
+
+  PointReader<Point> reader(file);
+  vector<Point> block;
+  ASSERT_TRUE(reader.readBlock(block));
+  EXPECT_EQ(block.size(), 1000);
+  EXPECT_EQ(block.front(), points.front());
+
+  seek(file, 0, SEEK_SET);
+  vector<Point> loaded = readPoints<Point>(file);
+  ASSERT_EQ(loaded.size(), points.size() + 10);
+  EXPECT_TRUE(equal(points.begin(), points.end(), loaded.begin()));
+  EXPECT_TRUE(equal(points.begin(), points.begin() + 10, loaded.begin() + points.size()));
+}
+
+TEST(VectorCodecTest, corruptBlock) {
+  typedef ArrNi<false, int32_t, 2> Point;
+  using namespace common613::file;
+
+  vector<Point> points = randomWalk<Point>(100, 100, 5);
+  Memory encoded;
+  encodeDeltas(points.data(), points.size(), encoded);
+  EXPECT_TRUE(common613::mayEncodeDeltas<Point>(points.size(), encoded.size()));
+  EXPECT_FALSE(common613::mayEncodeDeltas<Point>(encoded.size(), encoded.size()));
+
+  vector<Point> block;
+  {
+    File file(std::tmpfile());
+    PointBlockHeader header{0xFFFFFFFFU, 16};
+    write(file, &header);
+    seek(file, 0, SEEK_SET);
+    EXPECT_ANY_THROW(PointReader<Point>(file).readBlock(block));
+  }
+  {
+    File file(std::tmpfile());
+    PointBlockHeader header{1, 0xFFFFFFF0U};
+    write(file, &header);
+    write(file, encoded.data(), encoded.size());
+    seek(file, 0, SEEK_SET);
+    EXPECT_ANY_THROW(PointReader<Point>(file).readBlock(block));
+  }
+  {
+    File file(std::tmpfile());
+    PointBlockHeader header{static_cast<uint32_t>(points.size() - 1), static_cast<uint32_t>(encoded.size())};
+    write(file, &header);
+    write(file, encoded.data(), encoded.size());
+    seek(file, 0, SEEK_SET);
+    EXPECT_ANY_THROW(PointReader<Point>(file).readBlock(block));
+  }
+}
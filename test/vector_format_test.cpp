@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <common613/vector_arith_utils.h>
+#include <common613/vector_format.h>
+
+using namespace std;
+using common613::ArrNi;
+using common613::fromChars;
+using common613::parseArrays;
+using common613::toChars;
+
+TEST(VectorFormatTest, fmt) {
+  EXPECT_EQ(fmt::format("{}", ArrNi<false, int, 3>{1, -2, 3}), "(1, -2, 3)");
+  EXPECT_EQ(fmt::format("{:+}", ArrNi<true, int16_t, 2>{1, -2}), "(+1, -2)");
+  EXPECT_EQ(fmt::format("{:03}", ArrNi<true, int8_t, 1>{7}), "(007)");
+  EXPECT_EQ(fmt::format("{}", ArrNi<true, uint8_t, 2>{200, 0}), "(200, 0)");
+}
+
+TEST(VectorFormatTest, toChars) {
+  char buffer[32];
+  auto ret = toChars(buffer, buffer + sizeof(buffer), ArrNi<false, int, 3>{1, -23, 456});
+  ASSERT_EQ(ret.ec, std::errc());
+  EXPECT_EQ(string(buffer, ret.ptr), "1,-23,456");
+
+  ret = toChars(buffer, buffer + 5, ArrNi<false, int, 3>{1, -23, 456});
+  EXPECT_EQ(ret.ec, std::errc::value_too_large);
+}
+
+TEST(VectorFormatTest, fromChars) {
+  typedef ArrNi<false, int, 3> Point;
+  Point point{};
+
+  string text = "1,-23,456 rest";
+  auto ret = fromChars(text.data(), text.data() + text.size(), point);
+  ASSERT_EQ(ret.ec, std::errc());
+  EXPECT_EQ(point, Point::of(1, -23, 456));
+  EXPECT_EQ(string(ret.ptr), " rest");
+
+  text = fmt::format("{}", Point{-7, 8, 123456789});
+  ret = fromChars(text.data(), text.data() + text.size(), point);
+  ASSERT_EQ(ret.ec, std::errc());
+  EXPECT_EQ(point, Point::of(-7, 8, 123456789));
+  EXPECT_EQ(ret.ptr, text.data() + text.size());
+
+  text = "(1, 2";
+  EXPECT_EQ(fromChars(text.data(), text.data() + text.size(), point).ec, std::errc::invalid_argument);
+  text = "1,x,2";
+  EXPECT_NE(fromChars(text.data(), text.data() + text.size(), point).ec, std::errc());
+
+  ArrNi<true, int8_t, 2> small{};
+  text = "127,128";
+  EXPECT_EQ(fromChars(text.data(), text.data() + text.size(), small).ec, std::errc::result_out_of_range);
+
+  text = fmt::format("{:+}", Point{7, -8, 123456789});
+  ret = fromChars(text.data(), text.data() + text.size(), point);
+  ASSERT_EQ(ret.ec, std::errc());
+  EXPECT_EQ(point, Point::of(7, -8, 123456789));
+  EXPECT_EQ(ret.ptr, text.data() + text.size());
+  text = "+-1,2,3";
+  EXPECT_NE(fromChars(text.data(), text.data() + text.size(), point).ec, std::errc());
+}
+
+TEST(VectorFormatTest, outOfRangeEnd) {
+  // Long buffers take the SWAR path and short ones std::from_chars, and both stop after the digits.
+  for (string text : {"300", "300,        "}) {
+    int8_t value = 0;
+    auto ret = common613::internal::parseInteger(text.data(), text.data() + text.size(), value);
+    EXPECT_EQ(ret.ec, std::errc::result_out_of_range);
+    EXPECT_EQ(ret.ptr, text.data() + 3);
+  }
+}
+
+TEST(VectorFormatTest, parseArrays) {
+  typedef ArrNi<false, int32_t, 2> Point;
+
+  vector<Point> points;
+  EXPECT_EQ(parseArrays("1,2 3,4\n(-5, 6)\r\n7 8;", points), 4);
+  EXPECT_EQ(points, (vector<Point>{Point{1, 2}, Point{3, 4}, Point{-5, 6}, Point{7, 8}}));
+
+  points.clear();
+  EXPECT_EQ(parseArrays(fmt::format("{:+} {:+}", Point{1, -2}, Point{-3, 4}), points), 2);
+  EXPECT_EQ(points, (vector<Point>{Point{1, -2}, Point{-3, 4}}));
+
+  EXPECT_ANY_THROW(parseArrays("1,2,3", points));
+  EXPECT_ANY_THROW(parseArrays("1,2a", points));
+  EXPECT_ANY_THROW(parseArrays("1,99999999999", points));
+}
+
+TEST(VectorFormatTest, roundTrip) {
+  typedef ArrNi<true, int64_t, 3> Vector;
+
+  mt19937_64 random(613);
+  vector<Vector> expected;
+  string text;
+  for (int i = 0; i < 2000; ++i) {
+    int digits = i % 19;
+    int64_t bound = 1;
+    for (int j = 0; j < digits; ++j) {
+      bound *= 10;
+    }
+    uniform_int_distribution<int64_t> component(-bound, bound);
+    expected.push_back(Vector::of(component(random), component(random), component(random)));
+    text += (i % 2 == 0) ? fmt::format("{}\n", expected.back()) : fmt::format("{},{},{} ",
+        expected.back().x(), expected.back().y(), expected.back().z());
+  }
+  vector<Vector> parsed;
+  parseArrays(text, parsed);
+  EXPECT_EQ(parsed, expected);
+}
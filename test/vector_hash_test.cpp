@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+#include <gtest/gtest.h>
+#include <common613/vector_hash.h>
+
+using namespace std;
+using common613::ArrNi;
+using common613::hashValue;
+using common613::hashValues;
+
+TEST(VectorHashTest, consistency) {
+  typedef ArrNi<false, int32_t, 2> Point;
+
+  EXPECT_EQ(hashValue(Point{1, 2}), hashValue(Point{1, 2}));
+  EXPECT_NE(hashValue(Point{1, 2}), hashValue(Point{2, 1}));
+  EXPECT_NE(hashValue(Point{0, 0}), hashValue(Point{0, 1}));
+  EXPECT_EQ(std::hash<Point>{}(Point{-3, 7}), hashValue(Point{-3, 7}));
+
+  typedef ArrNi<true, int64_t, 3> Vector;
+  EXPECT_NE(hashValue(Vector{1, 2, 3}), hashValue(Vector{1, 3, 2}));
+  EXPECT_NE(hashValue(Vector{0, 0, 0}), hashValue(Vector{0, 0, 1}));
+
+  constexpr size_t hash = hashValue(ArrNi<true, int16_t, 3>{1, 2, 3});
+  EXPECT_EQ(hash, hashValue(ArrNi<true, int16_t, 3>::of(1, 2, 3)));
+}
+
+TEST(VectorHashTest, lowBitsSpread) {
+  typedef ArrNi<false, int32_t, 2> Point;
+
+  // A grid should spread evenly over buckets selected by low bits.
+  constexpr size_t bucketCount = 64;
+  vector<size_t> buckets(bucketCount);
+  for (int x = 0; x < 64; ++x) {
+    for (int y = 0; y < 64; ++y) {
+      ++buckets[hashValue(Point{x, y}) & (bucketCount - 1)];
+    }
+  }
+  for (size_t bucket : buckets) {
+    EXPECT_GT(bucket, 32u);
+    EXPECT_LT(bucket, 96u);
+  }
+}
+
+TEST(VectorHashTest, batch) {
+  typedef ArrNi<false, int16_t, 2> Point;
+
+  vector<Point> points;
+  for (int i = -50; i < 50; ++i) {
+    points.push_back(Point::of(i, i * 3));
+  }
+  vector<size_t> hashes(points.size());
+  hashValues(points.data(), points.size(), hashes.data());
+  for (size_t i = 0; i < points.size(); ++i) {
+    EXPECT_EQ(hashes[i], hashValue(points[i]));
+  }
+}
+
+TEST(VectorHashTest, unorderedSet) {
+  typedef ArrNi<true, int, 2> Vector;
+
+  unordered_set<Vector> set{Vector{1, 2}, Vector{2, 1}, Vector{1, 2}};
+  EXPECT_EQ(set.size(), 2);
+  EXPECT_EQ(set.count(Vector{2, 1}), 1);
+  EXPECT_EQ(set.count(Vector{2, 2}), 0);
+}
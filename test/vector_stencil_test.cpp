@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021 613_forever
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <common613/vector_stencil.h>
+
+using namespace std;
+using namespace common613;
+
+TEST(VectorStencilTest, neighborhoods) {
+  constexpr auto vonNeumann2 = vonNeumannOffsets<int, 2>();
+  static_assert(vonNeumann2.size() == 4, "4-neighborhood");
+  static_assert(mooreOffsets<int, 2>().size() == 8, "8-neighborhood");
+  static_assert(vonNeumannOffsets<int, 3>().size() == 6, "6-neighborhood");
+  static_assert(mooreOffsets<int, 3>().size() == 26, "26-neighborhood");
+  static_assert(vonNeumannOffsets<int, 2, 2>().size() == 12, "diamond of radius 2");
+  static_assert(mooreOffsets<int16_t, 2, 2>().size() == 24, "square of radius 2");
+  static_assert(vonNeumann2[0].x() == 0 && vonNeumann2[0].y() == -1, "ordered with x varying fastest");
+
+  using Vec2 = ArrNi<true, int, 2>;
+  array<Vec2, 4> expected{Vec2::of(0, -1), Vec2::of(-1, 0), Vec2::of(1, 0), Vec2::of(0, 1)};
+  EXPECT_EQ(vonNeumann2, expected);
+  for (const auto& offset : mooreOffsets<int, 3, 2>()) {
+    EXPECT_LE(max({abs(offset.x()), abs(offset.y()), abs(offset.z())}), 2);
+    EXPECT_NE(offset, (ArrNi<true, int, 3>{}));
+  }
+}
+
+TEST(VectorStencilTest, linearOffsets) {
+  auto linear = linearOffsets(ArrNi<true, int, 3>::of(10, 20, 30), vonNeumannOffsets<int, 3>());
+  array<ptrdiff_t, 6> expected{-200, -10, -1, 1, 10, 200};
+  EXPECT_EQ(linear, expected);
+}
+
+namespace {
+
+template <size_t N, size_t K>
+void checkStencil(const ArrNi<true, int, N>& shape, const array<ArrNi<true, int, N>, K>& offsets) {
+  size_t size = 1;
+  for (size_t d = 0; d < N; ++d) {
+    size *= shape.arr[d];
+  }
+  mt19937 random(613);
+  vector<int> input(size);
+  for (int& value : input) {
+    value = static_cast<int>(random() % 1000);
+  }
+  vector<long> output(size, -1);
+  applyStencil(shape, offsets, input.data(), output.data(), -7, [](int center, const array<int, K>& neighbors) {
+    long sum = center * 1000L;
+    for (size_t k = 0; k < K; ++k) {
+      sum += neighbors[k] * static_cast<long>(k + 1);
+    }
+    return sum;
+  });
+
+  ArrNi<false, int, N> position{};
+  for (size_t i = 0; i < size; ++i) {
+    long expected = input[i] * 1000L;
+    for (size_t k = 0; k < K; ++k) {
+      bool inside = true;
+      size_t index = 0, stride = 1;
+      for (size_t d = 0; d < N; ++d) {
+        int coordinate = position.arr[d] + offsets[k].arr[d];
+        inside &= coordinate >= 0 && coordinate < shape.arr[d];
+        index += coordinate * stride;
+        stride *= shape.arr[d];
+      }
+      expected += (inside ? input[index] : -7) * static_cast<long>(k + 1);
+    }
+    ASSERT_EQ(output[i], expected) << "at index " << i;
+    for (size_t d = 0; d < N && ++position.arr[d] == shape.arr[d]; ++d) {
+      position.arr[d] = 0;
+    }
+  }
+}
+
+}
+
+TEST(VectorStencilTest, apply) {
+  checkStencil(ArrNi<true, int, 1>::of(50), mooreOffsets<int, 1, 3>());
+  checkStencil(ArrNi<true, int, 2>::of(37, 23), vonNeumannOffsets<int, 2>());
+  checkStencil(ArrNi<true, int, 2>::of(37, 23), mooreOffsets<int, 2, 2>());
+  checkStencil(ArrNi<true, int, 2>::of(3, 2), mooreOffsets<int, 2, 2>());
+  checkStencil(ArrNi<true, int, 3>::of(11, 7, 5), mooreOffsets<int, 3>());
+  checkStencil(ArrNi<true, int, 3>::of(11, 7, 5), vonNeumannOffsets<int, 3>());
+  using Vec2 = ArrNi<true, int, 2>;
+  checkStencil(Vec2::of(9, 8), array<Vec2, 3>{Vec2::of(2, 0), Vec2::of(3, 1), Vec2::of(0, -2)});
+  checkStencil(Vec2::of(9, 0), vonNeumannOffsets<int, 2>());
+}